@@ -0,0 +1,52 @@
+/*
+ * baseline.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ */
+
+#include "baseline.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static bool json_number(const char *line, const char *key, double *value)
+{
+	char pattern[64];
+	snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+	const char *p = strstr(line, pattern);
+	if (p == NULL) return false;
+	*value = strtod(p + strlen(pattern), NULL);
+	return true;
+}
+
+static bool json_string(const char *line, const char *key, std::string *value)
+{
+	char pattern[64];
+	snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
+	const char *p = strstr(line, pattern);
+	if (p == NULL) return false;
+	p += strlen(pattern);
+	const char *end = strchr(p, '"');
+	if (end == NULL) return false;
+	value->assign(p, end - p);
+	return true;
+}
+
+bool load_baseline(const char *filename, std::map<std::string, struct baseline_entry> &entries)
+{
+	FILE *f = fopen(filename, "r");
+	if (f == NULL) return false;
+
+	char line[1024];
+	while (fgets(line, sizeof(line), f)) {
+		std::string name;
+		struct baseline_entry entry;
+		if (!json_string(line, "name", &name) ||
+		    !json_number(line, "ns_per_instruction", &entry.ns)) continue;
+		if (!json_number(line, "mad_ns", &entry.mad)) entry.mad = 0.0;
+		entries[name] = entry;
+	}
+
+	fclose(f);
+	return !entries.empty();
+}
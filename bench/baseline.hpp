@@ -0,0 +1,27 @@
+/*
+ * baseline.hpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Baselines for the mc6809_bench regression gate: earlier output of
+ * mc6809_bench itself, read back.
+ */
+
+#ifndef BASELINE_HPP
+#define BASELINE_HPP
+
+#include <map>
+#include <string>
+
+struct baseline_entry {
+	double ns;			// median ns per instruction
+	double mad;			// median absolute deviation, ns
+};
+
+/*
+ * Relies on the layout mc6809_bench writes, one result per line.
+ * Returns false when the file can't be read or has no results.
+ */
+bool load_baseline(const char *filename, std::map<std::string, struct baseline_entry> &entries);
+
+#endif
@@ -0,0 +1,660 @@
+/*
+ * mc6809_bench.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Microbenchmarks for the interpreter core, one per opcode class. Each
+ * one runs a single instruction, unrolled BENCH_UNROLL times and closed
+ * by a jmp, with instruments off.
+ *
+ * Workloads are complete programs (bench/workloads), run from reset
+ * until they end in a branch to itself. The 32 bit word they leave at
+ * WORKLOAD_RESULT must match the known checksum.
+ *
+ * Before timing anything, every indexed postbyte is checked against a
+ * reference decoder (see check_indexed()).
+ *
+ *   mc6809_bench [-n instructions] [-r repetitions] [-f filter] [-p]
+ *                [-b baseline.json] [-t tolerance] [-s period]
+ *
+ * With -p, host cycles, instructions, branch misses and l1 icache
+ * misses are counted around every run (see perf_counters.hpp).
+ *
+ * With -s, everything runs with the sampling profiler on, taking a
+ * sample every period cycles, to measure its overhead.
+ *
+ * With -b, results are compared to an earlier output of mc6809_bench.
+ * The exit status is 2 when a benchmark got significantly slower (see
+ * regression()), 1 when a workload checksum or the indexed check is
+ * wrong.
+ *
+ * Results (median of the repetitions) are written to stdout as JSON,
+ * everything else, including the messages of the core, goes to stderr.
+ *
+ * mc6809_bench_unity is the same program built with MC6809_IMPLEMENTATION,
+ * the core amalgamated into this file instead of linked from the library.
+ */
+
+#include "mc6809.hpp"
+#include "baseline.hpp"
+#include "perf_counters.hpp"
+#include "workloads.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#define	BENCH_CODE	0x1000
+#define	BENCH_HANDLER	0x3000
+#define	BENCH_DATA	0x4000
+#define	BENCH_STACK	0x8000
+#define	BENCH_UNROLL	16
+
+#define	BENCH_IRQ	0x01
+#define	BENCH_FIRQ	0x02
+
+#define	WORKLOAD_RESULT	0x0000
+#define	TIMER_ACK	0xdf00
+
+#define	INDEXED_STATES	40
+
+#ifdef MC6809_IMPLEMENTATION
+#define	BENCH_BUILD	"unity"
+#else
+#define	BENCH_BUILD	"split"
+#endif
+
+static uint8_t memory[65536];
+static bool line_high = true;
+static bool timer_line = true;
+static struct perf_counters counters;
+
+class cpu_t final : public mc6809 {
+public:
+	uint8_t read8(uint16_t address) const { return memory[address]; }
+	void write8(uint16_t address, uint8_t value) const {
+		if (address == TIMER_ACK) timer_line = true;
+		memory[address] = value;
+	}
+};
+
+struct benchmark {
+	const char *name;
+	const char *group;
+	uint8_t cc;
+	uint8_t lines;
+	uint8_t length;
+	uint8_t code[5];
+};
+
+/*
+ * cc is set before the loop starts, Z_FLAG decides the branches.
+ * Indexed modes use lda with x (or pc), pointers read from memory are
+ * zero, so indirect modes load from $0000.
+ */
+static const struct benchmark benchmarks[] = {
+	{ "alu_imm",        "alu",       0,      0, 2, { 0x8b, 0x01 } },		// adda #$01
+	{ "alu_dir",        "alu",       0,      0, 2, { 0x9b, 0x40 } },		// adda <$40
+	{ "alu_idx",        "alu",       0,      0, 2, { 0xab, 0x84 } },		// adda ,x
+	{ "alu_ext",        "alu",       0,      0, 3, { 0xbb, 0x20, 0x00 } },	// adda $2000
+	{ "alu16_imm",      "alu",       0,      0, 3, { 0xc3, 0x00, 0x01 } },	// addd #$0001
+	{ "alu16_ext",      "alu",       0,      0, 3, { 0xf3, 0x20, 0x00 } },	// addd $2000
+	{ "st_ext",         "alu",       0,      0, 3, { 0xb7, 0x20, 0x00 } },	// sta $2000
+	{ "inh_inca",       "alu",       0,      0, 1, { 0x4c } },			// inca
+	{ "mul",            "alu",       0,      0, 1, { 0x3d } },			// mul
+	{ "daa",            "alu",       0,      0, 1, { 0x19 } },			// daa
+	{ "bra",            "branch",    0,      0, 2, { 0x20, 0x00 } },		// bra *+2
+	{ "bcc_taken",      "branch",    Z_FLAG, 0, 2, { 0x27, 0x00 } },		// beq *+2
+	{ "bcc_not_taken",  "branch",    Z_FLAG, 0, 2, { 0x26, 0x00 } },		// bne *+2
+	{ "lbcc_taken",     "branch",    Z_FLAG, 0, 4, { 0x10, 0x27, 0x00, 0x00 } },	// lbeq *+4
+	{ "lbcc_not_taken", "branch",    Z_FLAG, 0, 4, { 0x10, 0x26, 0x00, 0x00 } },	// lbne *+4
+	{ "pshs_puls",      "stack",     0,      0, 4, { 0x34, 0x7f, 0x35, 0x7f } },	// pshs/puls cc,d,dp,x,y,u
+	{ "pshu_pulu",      "stack",     0,      0, 4, { 0x36, 0x7f, 0x37, 0x7f } },	// pshu/pulu cc,d,dp,x,y,s
+	{ "idx_n5",         "indexed",   0,      0, 2, { 0xa6, 0x05 } },		// lda 5,x
+	{ "idx_inc",        "indexed",   0,      0, 2, { 0xa6, 0x80 } },		// lda ,x+
+	{ "idx_inc2",       "indexed",   0,      0, 2, { 0xa6, 0x81 } },		// lda ,x++
+	{ "idx_dec",        "indexed",   0,      0, 2, { 0xa6, 0x82 } },		// lda ,-x
+	{ "idx_dec2",       "indexed",   0,      0, 2, { 0xa6, 0x83 } },		// lda ,--x
+	{ "idx_zero",       "indexed",   0,      0, 2, { 0xa6, 0x84 } },		// lda ,x
+	{ "idx_b",          "indexed",   0,      0, 2, { 0xa6, 0x85 } },		// lda b,x
+	{ "idx_a",          "indexed",   0,      0, 2, { 0xa6, 0x86 } },		// lda a,x
+	{ "idx_n8",         "indexed",   0,      0, 3, { 0xa6, 0x88, 0x10 } },	// lda $10,x
+	{ "idx_n16",        "indexed",   0,      0, 4, { 0xa6, 0x89, 0x01, 0x00 } },	// lda $0100,x
+	{ "idx_d",          "indexed",   0,      0, 2, { 0xa6, 0x8b } },		// lda d,x
+	{ "idx_pc8",        "indexed",   0,      0, 3, { 0xa6, 0x8c, 0x00 } },	// lda 0,pc
+	{ "idx_pc16",       "indexed",   0,      0, 4, { 0xa6, 0x8d, 0x00, 0x00 } },	// lda 0,pc
+	{ "idx_ind_inc2",   "indexed",   0,      0, 2, { 0xa6, 0x91 } },		// lda [,x++]
+	{ "idx_ind_dec2",   "indexed",   0,      0, 2, { 0xa6, 0x93 } },		// lda [,--x]
+	{ "idx_ind_zero",   "indexed",   0,      0, 2, { 0xa6, 0x94 } },		// lda [,x]
+	{ "idx_ind_b",      "indexed",   0,      0, 2, { 0xa6, 0x95 } },		// lda [b,x]
+	{ "idx_ind_a",      "indexed",   0,      0, 2, { 0xa6, 0x96 } },		// lda [a,x]
+	{ "idx_ind_n8",     "indexed",   0,      0, 3, { 0xa6, 0x98, 0x10 } },	// lda [$10,x]
+	{ "idx_ind_n16",    "indexed",   0,      0, 4, { 0xa6, 0x99, 0x01, 0x00 } },	// lda [$0100,x]
+	{ "idx_ind_d",      "indexed",   0,      0, 2, { 0xa6, 0x9b } },		// lda [d,x]
+	{ "idx_ind_pc8",    "indexed",   0,      0, 3, { 0xa6, 0x9c, 0x00 } },	// lda [0,pc]
+	{ "idx_ind_pc16",   "indexed",   0,      0, 4, { 0xa6, 0x9d, 0x00, 0x00 } },	// lda [0,pc]
+	{ "idx_ind_ext",    "indexed",   0,      0, 4, { 0xa6, 0x9f, 0x20, 0x00 } },	// lda [$2000]
+	{ "swi_rti",        "interrupt", 0,      0, 1, { 0x3f } },			// swi
+	{ "irq_rti",        "interrupt", 0,      BENCH_IRQ, 1, { 0x12 } },		// nop, irq held low
+	{ "firq_rti",       "interrupt", 0,      BENCH_FIRQ, 1, { 0x12 } },		// nop, firq held low
+};
+
+/*
+ * Known results and the timer period in cycles (0 is no timer). The
+ * timer pulls irq low until the guest writes to TIMER_ACK.
+ */
+static const struct {
+	const char *name;
+	uint32_t checksum;
+	uint32_t timer;
+} workload_checks[] = {
+	{ "sieve",     0x00002020,   0 },	// 8 passes * 1028 primes below 8192
+	{ "crc16",     0x000077a5,   0 },
+	{ "crc32",     0xee7e6ed1,   0 },
+	{ "memcpy",    0x0000f800,   0 },
+	{ "bubble",    0x2a80ff00,   0 },
+	{ "quicksort", 0xbc00f800,   0 },
+	{ "bcd",       0x24710626,   0 },	// F(20001) mod 10^8, bcd
+	{ "timer",     0x0bebe910, 100 },	// 20000 * 20001 / 2
+};
+
+struct sample {
+	double ns;			// per instruction
+	uint64_t counts[PERF_COUNTERS];
+};
+
+struct result {
+	const char *name;
+	const char *group;
+	uint64_t instructions;
+	uint64_t cycles;
+	struct sample median;
+	double mad;			// median absolute deviation, ns
+	int checksum;			// -1 not checked, 0 wrong, 1 ok
+};
+
+static const char *counter_names[PERF_COUNTERS] = {
+	"cycles", "instructions", "branch_misses", "l1i_misses"
+};
+
+/*
+ * Median of the repetitions, by time
+ */
+static struct sample median(std::vector<struct sample> &samples)
+{
+	std::sort(samples.begin(), samples.end(),
+		[](const struct sample &a, const struct sample &b) { return a.ns < b.ns; });
+	return samples[samples.size() / 2];
+}
+
+static double median_absolute_deviation(const std::vector<struct sample> &samples,
+					double median)
+{
+	std::vector<double> deviations;
+	for (const struct sample &s : samples) deviations.push_back(fabs(s.ns - median));
+	std::sort(deviations.begin(), deviations.end());
+	return deviations[deviations.size() / 2];
+}
+
+/*
+ * Significantly slower: the median is more than tolerance percent
+ * above the baseline and the difference is beyond the noise of both
+ * runs, 3 sigma with sigma estimated as 1.4826 * mad.
+ */
+static bool regression(double ns, double mad, const struct baseline_entry &base,
+		       double tolerance)
+{
+	double noise = 3.0 * 1.4826 * std::max(mad, base.mad);
+	return (ns > base.ns * (1.0 + tolerance / 100.0)) && ((ns - base.ns) > noise);
+}
+
+static struct sample take_sample(double ns)
+{
+	struct sample s;
+	s.ns = ns;
+	memcpy(s.counts, counters.values, sizeof(s.counts));
+	return s;
+}
+
+/*
+ * Runs the benchmark and returns the ns per instruction. Once an
+ * interrupt line is low, the loop alternates between the entry and
+ * the rti of the handler.
+ */
+static double run(cpu_t *cpu, const struct benchmark *b, uint32_t instructions,
+		  uint64_t *cycles)
+{
+	bool irq_line = !(b->lines & BENCH_IRQ);
+	bool firq_line = !(b->lines & BENCH_FIRQ);
+
+	cpu->assign_irq_line(&irq_line);
+	cpu->assign_firq_line(&firq_line);
+	cpu->set_pc(BENCH_CODE);
+	cpu->set_sp(BENCH_STACK);
+	cpu->set_us(BENCH_STACK - 0x100);
+	cpu->set_xr(BENCH_DATA);
+	cpu->set_yr(BENCH_DATA);
+	cpu->set_dp(0x20);
+	cpu->set_dr(0x0000);
+	cpu->set_cc(b->cc);
+
+	uint64_t sum = 0;
+	perf_counters_start(&counters);
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i=0; i<instructions; i++) {
+		sum += cpu->execute();
+	}
+	auto end = std::chrono::steady_clock::now();
+	perf_counters_stop(&counters);
+
+	cpu->assign_irq_line(&line_high);
+	cpu->assign_firq_line(&line_high);
+	*cycles = sum;
+	return std::chrono::duration<double, std::nano>(end - start).count() / instructions;
+}
+
+static void load(const struct benchmark *b)
+{
+	memset(memory, 0, sizeof(memory));
+
+	uint16_t address = BENCH_CODE;
+	for (int i=0; i<BENCH_UNROLL; i++) {
+		memcpy(&memory[address], b->code, b->length);
+		address += b->length;
+	}
+	memory[address++] = 0x7e;			// jmp BENCH_CODE
+	memory[address++] = BENCH_CODE >> 8;
+	memory[address++] = BENCH_CODE & 0xff;
+
+	memory[BENCH_HANDLER] = 0x3b;			// rti
+	for (uint16_t vector = 0xfff6; vector < 0xfffe; vector += 2) {
+		memory[vector] = BENCH_HANDLER >> 8;	// firq, irq, swi, nmi
+		memory[vector + 1] = BENCH_HANDLER & 0xff;
+	}
+	memory[0xfffe] = BENCH_CODE >> 8;
+	memory[0xffff] = BENCH_CODE & 0xff;
+}
+
+/*
+ * Runs a workload from reset, returns the ns it took
+ */
+static double run_workload(cpu_t *cpu, const struct workload *w, uint32_t timer,
+			   uint64_t *instructions, uint64_t *cycles)
+{
+	memset(memory, 0, sizeof(memory));
+	memcpy(&memory[WORKLOAD_ROM], w->code, w->size);
+	memcpy(&memory[0xfff0], w->vectors, 16);
+
+	timer_line = true;
+	cpu->assign_irq_line(&timer_line);
+	cpu->reset();
+
+	uint64_t n = 0, sum = 0, next = timer;
+	perf_counters_start(&counters);
+	auto start = std::chrono::steady_clock::now();
+	while (true) {
+		uint16_t pc = cpu->get_pc();
+		sum += cpu->execute();
+		n++;
+		if (cpu->get_pc() == pc) break;
+		if (timer && (sum >= next)) {
+			timer_line = false;
+			next += timer;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	perf_counters_stop(&counters);
+
+	cpu->assign_irq_line(&line_high);
+	*instructions = n;
+	*cycles = sum;
+	return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+static uint32_t workload_result()
+{
+	return (memory[WORKLOAD_RESULT] << 24) | (memory[WORKLOAD_RESULT + 1] << 16) |
+		(memory[WORKLOAD_RESULT + 2] << 8) | memory[WORKLOAD_RESULT + 3];
+}
+
+/*
+ * Reference decode of an indexed postbyte, written down from the data
+ * sheet independently of the core. regs are x, y, u and s, pc points
+ * right after the postbyte. Returns false for an illegal postbyte.
+ */
+struct indexed_reference {
+	uint16_t address;	// effective address
+	uint16_t base;		// base register afterwards
+	int cycles;		// on top of the opcode
+	int bytes;		// operand bytes after the postbyte
+};
+
+static bool reference_indexed(uint8_t postbyte, const uint16_t *regs, uint8_t a,
+			      uint8_t b, uint16_t pc, struct indexed_reference *r)
+{
+	uint16_t base = regs[(postbyte >> 5) & 0b11];
+	uint16_t word = (memory[pc] << 8) | memory[(uint16_t)(pc + 1)];
+	bool indirect = postbyte & 0b00010000;
+	uint16_t address;
+
+	r->bytes = 0;
+
+	if (!(postbyte & 0b10000000)) {
+		// 5 bit offset, never indirect
+		r->address = base + ((postbyte & 0b00010000) ?
+			(postbyte & 0b00011111) - 32 : (postbyte & 0b00001111));
+		r->base = base;
+		r->cycles = 1;
+		return true;
+	}
+
+	switch (postbyte & 0b00001111) {
+	case 0x0: if (indirect) return false; address = base; base += 1; r->cycles = 2; break;
+	case 0x1: address = base; base += 2; r->cycles = 3; break;
+	case 0x2: if (indirect) return false; base -= 1; address = base; r->cycles = 2; break;
+	case 0x3: base -= 2; address = base; r->cycles = 3; break;
+	case 0x4: address = base; r->cycles = 0; break;
+	case 0x5: address = base + (int8_t)b; r->cycles = 1; break;
+	case 0x6: address = base + (int8_t)a; r->cycles = 1; break;
+	case 0x8: address = base + (int8_t)memory[pc]; r->bytes = 1; r->cycles = 1; break;
+	case 0x9: address = base + word; r->bytes = 2; r->cycles = 4; break;
+	case 0xb: address = base + ((a << 8) | b); r->cycles = 4; break;
+	case 0xc: address = pc + 1 + (int8_t)memory[pc]; r->bytes = 1; r->cycles = 1; break;
+	case 0xd: address = pc + 2 + word; r->bytes = 2; r->cycles = 5; break;
+	case 0xf:
+		// [n16] only, 5 cycles in total
+		if (postbyte != 0x9f) return false;
+		address = word;
+		r->bytes = 2;
+		r->cycles = 2;
+		break;
+	default:
+		return false;
+	}
+
+	if (indirect) {
+		address = (memory[address] << 8) | memory[(uint16_t)(address + 1)];
+		r->cycles += 3;
+	}
+	r->address = address;
+	r->base = base;
+	return true;
+}
+
+static uint32_t xorshift32(uint32_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+/*
+ * Runs every postbyte under leax (leay when x is the base) from
+ * INDEXED_STATES random register states, on random memory, and
+ * compares effective address, registers, pc and cycles with the
+ * reference. Illegal postbytes must end up in the exception handler.
+ * Returns the number of mismatches.
+ */
+static int check_indexed(cpu_t *cpu)
+{
+	uint32_t random = 0x6809;
+	int errors = 0;
+
+	cpu->assign_irq_line(&line_high);
+	cpu->assign_firq_line(&line_high);
+
+	for (int postbyte = 0; postbyte < 256; postbyte++) {
+		for (int i=0; i<65536; i++) memory[i] = xorshift32(&random);
+		memory[VECTOR_ILL_OPC] = BENCH_HANDLER >> 8;
+		memory[VECTOR_ILL_OPC + 1] = BENCH_HANDLER & 0xff;
+
+		bool base_x = ((postbyte >> 5) & 0b11) == 0;
+		memory[BENCH_CODE] = base_x ? 0x31 : 0x30;	// leay or leax
+		memory[BENCH_CODE + 1] = postbyte;
+
+		for (int state = 0; state < INDEXED_STATES; state++) {
+			uint16_t regs[4];
+			for (int r=0; r<4; r++) regs[r] = xorshift32(&random);
+			uint16_t d = xorshift32(&random);
+			memory[BENCH_CODE + 2] = xorshift32(&random);
+			memory[BENCH_CODE + 3] = xorshift32(&random);
+
+			struct indexed_reference r;
+			bool legal = reference_indexed(postbyte, regs, d >> 8, d & 0xff,
+						       BENCH_CODE + 2, &r);
+			if (!legal) {
+				// keep the stacked registers away from code and vectors
+				regs[3] = BENCH_STACK;
+			}
+
+			cpu->set_xr(regs[0]);
+			cpu->set_yr(regs[1]);
+			cpu->set_us(regs[2]);
+			cpu->set_sp(regs[3]);
+			cpu->set_dr(d);
+			cpu->set_cc(0);
+			cpu->set_pc(BENCH_CODE);
+			uint16_t cycles = cpu->execute();
+
+			bool ok;
+			if (legal) {
+				uint16_t after[4] = { regs[0], regs[1], regs[2], regs[3] };
+				after[(postbyte >> 5) & 0b11] = r.base;
+				after[base_x ? 1 : 0] = r.address;
+				ok = (cpu->get_xr() == after[0]) && (cpu->get_yr() == after[1]) &&
+					(cpu->get_us() == after[2]) && (cpu->get_sp() == after[3]) &&
+					(cpu->get_pc() == BENCH_CODE + 2 + r.bytes) &&
+					(cycles == 4 + r.cycles);
+			} else {
+				ok = cpu->get_pc() == BENCH_HANDLER;
+			}
+			if (!ok && (errors++ < 10)) {
+				fprintf(stderr, "error: indexed postbyte $%02x, x=$%04x y=$%04x "
+					"u=$%04x s=$%04x d=$%04x\n", postbyte, regs[0],
+					regs[1], regs[2], regs[3], d);
+			}
+		}
+	}
+	return errors;
+}
+
+/*
+ * Counters per guest instruction, host ipc when both cycles and
+ * instructions are there. Counters were opened before the results,
+ * so the fds tell which ones are valid.
+ */
+static void print_counters(FILE *f, const struct result *r)
+{
+	const uint64_t *counts = r->median.counts;
+	double n = r->instructions;
+
+	if (perf_counter_available(&counters, PERF_CYCLES) &&
+	    perf_counter_available(&counters, PERF_INSTRUCTIONS)) {
+		fprintf(f, ", \"host_ipc\": %.3f", counts[PERF_CYCLES] ?
+			(double)counts[PERF_INSTRUCTIONS] / counts[PERF_CYCLES] : 0.0);
+	}
+	for (int i=0; i<PERF_COUNTERS; i++) {
+		if (!perf_counter_available(&counters, (enum perf_counter_t)i)) continue;
+		fprintf(f, ", \"host_%s_per_instruction\": %.3f", counter_names[i],
+			counts[i] / n);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t instructions = 2000000;
+	int repetitions = 5;
+	const char *filter = NULL;
+	bool use_counters = false;
+	const char *baseline_file = NULL;
+	double tolerance = 5.0;
+	uint32_t sampler_period = 0;
+
+	int c;
+	while ((c = getopt(argc, argv, "n:r:f:pb:t:s:")) != -1) {
+		switch (c) {
+		case 'n': instructions = strtoul(optarg, NULL, 0); break;
+		case 'r': repetitions = atoi(optarg); break;
+		case 'f': filter = optarg; break;
+		case 'p': use_counters = true; break;
+		case 'b': baseline_file = optarg; break;
+		case 't': tolerance = atof(optarg); break;
+		case 's': sampler_period = strtoul(optarg, NULL, 0); break;
+		default:
+			fprintf(stderr, "usage: mc6809_bench [-n instructions] [-r repetitions] [-f filter] [-p]\n"
+					"                    [-b baseline.json] [-t tolerance] [-s period]\n");
+			return 1;
+		}
+	}
+
+	std::map<std::string, struct baseline_entry> baseline;
+	if (baseline_file && !load_baseline(baseline_file, baseline)) {
+		fprintf(stderr, "error: can't read baseline %s\n", baseline_file);
+		return 1;
+	}
+	if (instructions == 0) instructions = 1;
+	if (repetitions < 1) repetitions = 1;
+
+	for (int i=0; i<PERF_COUNTERS; i++) counters.fd[i] = -1;
+	if (use_counters && (perf_counters_open(&counters) == 0)) {
+		fprintf(stderr, "hardware counters unavailable, wall time only\n");
+	}
+
+	/*
+	 * The core prints to stdout, only the json goes there
+	 */
+	fflush(stdout);
+	FILE *json = fdopen(dup(STDOUT_FILENO), "w");
+	dup2(STDERR_FILENO, STDOUT_FILENO);
+
+	cpu_t *cpu = new cpu_t;
+	std::vector<struct result> results;
+	bool checksums_ok = true;
+
+	int indexed_errors = check_indexed(cpu);
+	fprintf(stderr, "indexed postbytes: %i mismatches in %i runs\n",
+		indexed_errors, 256 * INDEXED_STATES);
+	if (indexed_errors) checksums_ok = false;
+
+	if (sampler_period) cpu->enable_sampler(true, sampler_period);
+
+	for (const struct benchmark &b : benchmarks) {
+		if (filter && (strstr(b.name, filter) == NULL)) continue;
+
+		load(&b);
+		cpu->reset();
+
+		uint64_t cycles;
+		run(cpu, &b, instructions / 10 + 1, &cycles);	// warm up
+
+		std::vector<struct sample> samples;
+		for (int i=0; i<repetitions; i++) {
+			samples.push_back(take_sample(run(cpu, &b, instructions, &cycles)));
+		}
+		struct sample m = median(samples);
+
+		results.push_back({ b.name, b.group, instructions, cycles, m,
+			median_absolute_deviation(samples, m.ns), -1 });
+		fprintf(stderr, "%-16s %8.2f ns/instruction\n", b.name, m.ns);
+	}
+
+	for (const struct workload *w = workloads; w->name; w++) {
+		if (filter && (strstr(w->name, filter) == NULL)) continue;
+
+		uint32_t checksum = 0, timer = 0;
+		for (const auto &check : workload_checks) {
+			if (strcmp(check.name, w->name) == 0) {
+				checksum = check.checksum;
+				timer = check.timer;
+			}
+		}
+
+		uint64_t n, cycles;
+		run_workload(cpu, w, timer, &n, &cycles);	// warm up
+
+		std::vector<struct sample> samples;
+		bool ok = true;
+		for (int i=0; i<repetitions; i++) {
+			samples.push_back(take_sample(run_workload(cpu, w, timer, &n, &cycles) / n));
+			if (workload_result() != checksum) ok = false;
+		}
+		struct sample m = median(samples);
+
+		if (!ok) {
+			fprintf(stderr, "error: %s ended with $%08x, expected $%08x\n",
+				w->name, workload_result(), checksum);
+			checksums_ok = false;
+		}
+		results.push_back({ w->name, "workload", n, cycles, m,
+			median_absolute_deviation(samples, m.ns), ok });
+		fprintf(stderr, "%-16s %8.2f ns/instruction %8.2f MIPS\n", w->name,
+			m.ns, 1000.0 / m.ns);
+	}
+
+	delete cpu;
+	perf_counters_close(&counters);
+
+	bool regressed = false;
+	if (baseline_file) {
+		fprintf(stderr, "\n%-16s %10s %10s %8s\n", "benchmark", "baseline", "current", "delta");
+		for (const struct result &r : results) {
+			auto base = baseline.find(r.name);
+			if (base == baseline.end()) {
+				fprintf(stderr, "%-16s %10s %10.3f %8s new\n", r.name, "-", r.median.ns, "");
+				continue;
+			}
+			bool slower = regression(r.median.ns, r.mad, base->second, tolerance);
+			double delta = 100.0 * (r.median.ns - base->second.ns) / base->second.ns;
+			fprintf(stderr, "%-16s %10.3f %10.3f %+7.1f%% %s\n", r.name,
+				base->second.ns, r.median.ns, delta,
+				slower ? "SLOWER" : ((delta < -tolerance) ? "faster" : "ok"));
+			if (slower) regressed = true;
+		}
+		if (regressed) {
+			fprintf(stderr, "error: slower than baseline (tolerance %.1f%%)\n", tolerance);
+		}
+	}
+
+	fprintf(json, "{\n");
+	fprintf(json, "  \"suite\": \"mc6809_bench\",\n");
+	fprintf(json, "  \"version\": \"%i.%i.%i\",\n", MC6809_MAJOR_VERSION,
+		MC6809_MINOR_VERSION, MC6809_BUILD);
+	fprintf(json, "  \"build\": \"%s\",\n", BENCH_BUILD);
+	fprintf(json, "  \"unroll\": %i,\n", BENCH_UNROLL);
+	fprintf(json, "  \"repetitions\": %i,\n", repetitions);
+	fprintf(json, "  \"sampler_period\": %u,\n", sampler_period);
+	fprintf(json, "  \"counters\": [");
+	for (int i=0, n=0; i<PERF_COUNTERS; i++) {
+		if (counters.fd[i] < 0) continue;
+		fprintf(json, "%s\"%s\"", n++ ? ", " : "", counter_names[i]);
+	}
+	fprintf(json, "],\n");
+	fprintf(json, "  \"results\": [\n");
+	for (size_t i=0; i<results.size(); i++) {
+		const struct result &r = results[i];
+		double ns = r.median.ns;
+		double ns_per_cycle = ns * r.instructions / r.cycles;
+		fprintf(json, "    { \"name\": \"%s\", \"group\": \"%s\", "
+			"\"instructions\": %llu, \"cycles\": %llu, "
+			"\"ns_per_instruction\": %.3f, \"ns_per_cycle\": %.3f, "
+			"\"mad_ns\": %.3f, \"mips\": %.3f, \"emulated_mhz\": %.3f",
+			r.name, r.group,
+			(unsigned long long)r.instructions, (unsigned long long)r.cycles,
+			ns, ns_per_cycle, r.mad, 1000.0 / ns, 1000.0 / ns_per_cycle);
+		print_counters(json, &r);
+		if (r.checksum >= 0) {
+			fprintf(json, ", \"checksum_ok\": %s", r.checksum ? "true" : "false");
+		}
+		fprintf(json, " }%s\n", (i + 1 < results.size()) ? "," : "");
+	}
+	fprintf(json, "  ]\n");
+	fprintf(json, "}\n");
+	fclose(json);
+
+	if (!checksums_ok) return 1;
+	return regressed ? 2 : 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * perf_counters.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ */
+
+#include "perf_counters.hpp"
+#include <cstring>
+
+#ifdef __linux__
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int open_counter(uint32_t type, uint64_t config)
+{
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/*
+ * Counters are opened one by one instead of as a group, so one that
+ * isn't supported (l1 icache misses often aren't) doesn't take the
+ * others with it.
+ */
+int perf_counters_open(struct perf_counters *p)
+{
+	p->fd[PERF_CYCLES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	p->fd[PERF_INSTRUCTIONS] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	p->fd[PERF_BRANCH_MISSES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+	p->fd[PERF_L1I_MISSES] = open_counter(PERF_TYPE_HW_CACHE,
+		PERF_COUNT_HW_CACHE_L1I |
+		(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+		(PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+
+	int n = 0;
+	for (int i=0; i<PERF_COUNTERS; i++) {
+		p->values[i] = 0;
+		if (p->fd[i] >= 0) n++;
+	}
+	return n;
+}
+
+void perf_counters_close(struct perf_counters *p)
+{
+	for (int i=0; i<PERF_COUNTERS; i++) {
+		if (p->fd[i] >= 0) close(p->fd[i]);
+		p->fd[i] = -1;
+	}
+}
+
+void perf_counters_start(struct perf_counters *p)
+{
+	for (int i=0; i<PERF_COUNTERS; i++) {
+		if (p->fd[i] < 0) continue;
+		ioctl(p->fd[i], PERF_EVENT_IOC_RESET, 0);
+		ioctl(p->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+	}
+}
+
+void perf_counters_stop(struct perf_counters *p)
+{
+	for (int i=0; i<PERF_COUNTERS; i++) {
+		if (p->fd[i] < 0) continue;
+		ioctl(p->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+		uint64_t value;
+		p->values[i] = (read(p->fd[i], &value, sizeof(value)) == sizeof(value)) ? value : 0;
+	}
+}
+
+#else
+
+int perf_counters_open(struct perf_counters *p)
+{
+	for (int i=0; i<PERF_COUNTERS; i++) {
+		p->fd[i] = -1;
+		p->values[i] = 0;
+	}
+	return 0;
+}
+
+void perf_counters_close(struct perf_counters *p) {}
+void perf_counters_start(struct perf_counters *p) {}
+void perf_counters_stop(struct perf_counters *p) {}
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ * perf_counters.hpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Hardware performance counters for mc6809_bench, via perf_event_open
+ * on Linux. Counters that can't be opened (other systems, no pmu in a
+ * vm, perf_event_paranoid) read as unavailable.
+ */
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstdint>
+
+enum perf_counter_t {
+	PERF_CYCLES,
+	PERF_INSTRUCTIONS,
+	PERF_BRANCH_MISSES,
+	PERF_L1I_MISSES,
+	PERF_COUNTERS
+};
+
+struct perf_counters {
+	int fd[PERF_COUNTERS];		// -1 when unavailable
+	uint64_t values[PERF_COUNTERS];
+};
+
+/*
+ * Returns the number of counters that could be opened
+ */
+int perf_counters_open(struct perf_counters *p);
+void perf_counters_close(struct perf_counters *p);
+void perf_counters_start(struct perf_counters *p);
+void perf_counters_stop(struct perf_counters *p);
+
+inline bool perf_counter_available(const struct perf_counters *p, enum perf_counter_t c)
+{
+	return p->fd[c] >= 0;
+}
+
+#endif
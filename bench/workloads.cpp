@@ -0,0 +1,92 @@
+/*
+ * mc6809_bench (workloads.cpp) elmerucr (c)2026
+ *
+ * workload images for mc6809_bench, generated by bench/workloads
+ * Sun Oct 18 20:54:20 2026
+ */
+
+#include "workloads.hpp"
+
+static const uint8_t sieve_code[100] = {
+	0x10,0xce,0x10,0x00,0xcc,0x00,0x00,0xdd,0x00,0xdd,0x02,0x86,0x08,0x97,0x10,0x8e,
+	0x20,0x00,0xcc,0x01,0x01,0xed,0x81,0x8c,0x40,0x00,0x25,0xf9,0xce,0x00,0x02,0x1f,
+	0x30,0x1f,0x98,0x3d,0x10,0x83,0x20,0x00,0x24,0x1c,0x30,0xc9,0x20,0x00,0x6d,0x84,
+	0x27,0x10,0x8e,0x20,0x00,0x30,0x8b,0x6f,0x84,0x1f,0x30,0x30,0x8b,0x8c,0x40,0x00,
+	0x25,0xf5,0x33,0x41,0x20,0xd9,0x8e,0x20,0x02,0x10,0x8e,0x00,0x00,0x6d,0x80,0x27,
+	0x02,0x31,0x21,0x8c,0x40,0x00,0x25,0xf5,0x1f,0x20,0xd3,0x02,0xdd,0x02,0x0a,0x10,
+	0x26,0xad,0x20,0xfe
+};
+
+static const uint8_t crc16_code[66] = {
+	0x10,0xce,0x10,0x00,0xcc,0x00,0x00,0xdd,0x00,0xdd,0x02,0x86,0x04,0x97,0x10,0x8e,
+	0x20,0x00,0xc6,0x07,0xe7,0x80,0xcb,0x1d,0x8c,0x30,0x00,0x25,0xf7,0x8e,0x20,0x00,
+	0xcc,0xff,0xff,0xa8,0x80,0x10,0x8e,0x00,0x08,0x58,0x49,0x24,0x04,0x88,0x10,0xc8,
+	0x21,0x31,0x3f,0x26,0xf4,0x8c,0x30,0x00,0x25,0xe9,0xdd,0x02,0x0a,0x10,0x26,0xdd,
+	0x20,0xfe
+};
+
+static const uint8_t crc32_code[95] = {
+	0x10,0xce,0x10,0x00,0x86,0x02,0x97,0x10,0x8e,0x20,0x00,0xc6,0x07,0xe7,0x80,0xcb,
+	0x1d,0x8c,0x28,0x00,0x25,0xf7,0x8e,0x20,0x00,0xcc,0xff,0xff,0xdd,0x20,0xdd,0x22,
+	0xa6,0x80,0x98,0x23,0x97,0x23,0x10,0x8e,0x00,0x08,0x04,0x20,0x06,0x21,0x06,0x22,
+	0x06,0x23,0x24,0x10,0xdc,0x20,0x88,0xed,0xc8,0xb8,0xdd,0x20,0xdc,0x22,0x88,0x83,
+	0xc8,0x20,0xdd,0x22,0x31,0x3f,0x26,0xe2,0x8c,0x28,0x00,0x25,0xd3,0xdc,0x20,0x43,
+	0x53,0xdd,0x00,0xdc,0x22,0x43,0x53,0xdd,0x02,0x0a,0x10,0x26,0xb9,0x20,0xfe
+};
+
+static const uint8_t memcpy_code[84] = {
+	0x10,0xce,0x10,0x00,0xcc,0x00,0x00,0xdd,0x00,0xdd,0x02,0x86,0x20,0x97,0x10,0x8e,
+	0x20,0x00,0xc6,0x01,0xe7,0x80,0xcb,0x03,0x8c,0x30,0x00,0x25,0xf7,0x8e,0x20,0x00,
+	0x10,0x8e,0x40,0x00,0xa6,0x80,0xa7,0xa0,0x8c,0x30,0x00,0x25,0xf7,0x8e,0x40,0x00,
+	0x10,0x8e,0x60,0x00,0xec,0x81,0xed,0xa1,0x8c,0x50,0x00,0x25,0xf7,0x0a,0x10,0x26,
+	0xdc,0x8e,0x60,0x00,0xcc,0x00,0x00,0xeb,0x80,0x89,0x00,0x8c,0x70,0x00,0x25,0xf7,
+	0xdd,0x02,0x20,0xfe
+};
+
+static const uint8_t bubble_code[91] = {
+	0x10,0xce,0x10,0x00,0x8e,0x20,0x00,0xc6,0x5a,0x86,0x05,0x3d,0xcb,0x11,0xe7,0x80,
+	0x8c,0x22,0x00,0x25,0xf4,0xce,0x21,0xff,0xdf,0x10,0x8e,0x20,0x00,0xa6,0x84,0xa1,
+	0x01,0x23,0x06,0xe6,0x01,0xe7,0x84,0xa7,0x01,0x30,0x01,0x9c,0x10,0x25,0xee,0x33,
+	0x5f,0x11,0x83,0x20,0x00,0x22,0xe1,0xcc,0x00,0x00,0xdd,0x12,0xdd,0x14,0x8e,0x20,
+	0x00,0xe6,0x80,0x4f,0xd3,0x12,0xdd,0x12,0xd3,0x14,0xdd,0x14,0x8c,0x22,0x00,0x25,
+	0xf0,0xdc,0x14,0xdd,0x00,0xdc,0x12,0xdd,0x02,0x20,0xfe
+};
+
+static const uint8_t quicksort_code[141] = {
+	0x10,0xce,0x10,0x00,0x86,0x02,0x97,0x10,0x8e,0x20,0x00,0xc6,0x5a,0x86,0x05,0x3d,
+	0xcb,0x11,0xe7,0x80,0x8c,0x30,0x00,0x25,0xf4,0x8e,0x20,0x00,0x10,0x8e,0x2f,0xff,
+	0x8d,0x06,0x0a,0x10,0x26,0xe2,0x20,0x41,0x34,0x20,0xac,0xe1,0x24,0x3a,0xa6,0xa4,
+	0x97,0x11,0x1f,0x13,0x34,0x30,0xac,0x62,0x24,0x10,0xe6,0x84,0xd1,0x11,0x24,0x06,
+	0xa6,0xc4,0xe7,0xc0,0xa7,0x84,0x30,0x01,0x20,0xec,0x10,0xae,0x62,0xa6,0xc4,0xe6,
+	0xa4,0xe7,0xc4,0xa7,0xa4,0xae,0xe4,0x31,0x5f,0x34,0x40,0x8d,0xcb,0x35,0x40,0x30,
+	0x41,0x10,0xae,0x62,0x8d,0xc2,0x32,0x64,0x39,0xcc,0x00,0x00,0xdd,0x12,0xdd,0x14,
+	0x8e,0x20,0x00,0xe6,0x80,0x4f,0xd3,0x12,0xdd,0x12,0xd3,0x14,0xdd,0x14,0x8c,0x30,
+	0x00,0x25,0xf0,0xdc,0x14,0xdd,0x00,0xdc,0x12,0xdd,0x02,0x20,0xfe
+};
+
+static const uint8_t bcd_code[78] = {
+	0x10,0xce,0x10,0x00,0x8e,0x20,0x00,0x6f,0x80,0x8c,0x20,0x10,0x25,0xf9,0x86,0x01,
+	0xb7,0x20,0x0f,0xcc,0x27,0x10,0xdd,0x10,0x8e,0x20,0x08,0x10,0x8e,0x20,0x10,0x8d,
+	0x1e,0x8e,0x20,0x10,0x10,0x8e,0x20,0x08,0x8d,0x15,0xdc,0x10,0x83,0x00,0x01,0xdd,
+	0x10,0x26,0xe5,0xfc,0x20,0x0c,0xdd,0x00,0xfc,0x20,0x0e,0xdd,0x02,0x20,0xfe,0x1c,
+	0xfe,0xc6,0x08,0xa6,0x82,0xa9,0xa2,0x19,0xa7,0x84,0x5a,0x26,0xf6,0x39
+};
+
+static const uint8_t timer_code[64] = {
+	0x10,0xce,0x10,0x00,0xcc,0x00,0x00,0xdd,0x10,0xdd,0x12,0xdd,0x14,0x1c,0xef,0xdc,
+	0x10,0x10,0x83,0x4e,0x20,0x25,0xf8,0x1a,0x10,0xdc,0x12,0xdd,0x00,0xdc,0x14,0xdd,
+	0x02,0x20,0xfe,0x7f,0xdf,0x00,0xdc,0x10,0x10,0x83,0x4e,0x20,0x24,0x11,0xc3,0x00,
+	0x01,0xdd,0x10,0xd3,0x14,0xdd,0x14,0xdc,0x12,0xc9,0x00,0x89,0x00,0xdd,0x12,0x3b
+};
+
+const struct workload workloads[] = {
+	{ "sieve", sieve_code, sizeof(sieve_code), { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xe0,0x00 } },
+	{ "crc16", crc16_code, sizeof(crc16_code), { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xe0,0x00 } },
+	{ "crc32", crc32_code, sizeof(crc32_code), { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xe0,0x00 } },
+	{ "memcpy", memcpy_code, sizeof(memcpy_code), { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xe0,0x00 } },
+	{ "bubble", bubble_code, sizeof(bubble_code), { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xe0,0x00 } },
+	{ "quicksort", quicksort_code, sizeof(quicksort_code), { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xe0,0x00 } },
+	{ "bcd", bcd_code, sizeof(bcd_code), { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xe0,0x00 } },
+	{ "timer", timer_code, sizeof(timer_code), { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xe0,0x23,0x00,0x00,0x00,0x00,0xe0,0x00 } },
+	{ NULL, NULL, 0, { 0 } }
+};
@@ -0,0 +1,30 @@
+/*
+ * workloads.hpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Workload images for mc6809_bench, generated from the sources in
+ * bench/workloads (see the Makefile there).
+ */
+
+#ifndef WORKLOADS_HPP
+#define WORKLOADS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#define	WORKLOAD_ROM	0xe000
+
+struct workload {
+	const char *name;
+	const uint8_t *code;		// loaded at WORKLOAD_ROM
+	uint16_t size;
+	uint8_t vectors[16];		// $fff0-$ffff
+};
+
+/*
+ * Terminated by an entry with name NULL
+ */
+extern const struct workload workloads[];
+
+#endif
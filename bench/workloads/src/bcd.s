@@ -0,0 +1,58 @@
+; bcd.s - packed bcd arithmetic with daa
+;
+; Fibonacci numbers as 16 digit packed bcd (mod 10^16), 10000 double
+; steps up to F(20001). The result is the low 8 digits of F(20001).
+
+RESULT	equ	$0000
+COUNT	equ	$0010
+NUMA	equ	$2000
+NUMB	equ	$2008
+
+	section	TEXT
+
+vector_reset:
+	lds	#$1000
+	ldx	#NUMA
+.1	clr	,x+
+	cmpx	#NUMB+8
+	blo	.1
+	lda	#1
+	sta	NUMB+7
+	ldd	#10000
+	std	<COUNT
+
+loop:
+	ldx	#NUMA+8
+	ldy	#NUMB+8
+	bsr	add
+	ldx	#NUMB+8
+	ldy	#NUMA+8
+	bsr	add
+	ldd	<COUNT
+	subd	#1
+	std	<COUNT
+	bne	loop
+
+	ldd	NUMB+4
+	std	<RESULT
+	ldd	NUMB+6
+	std	<RESULT+2
+
+done:
+	bra	done
+
+; Adds the 8 byte number below y to the one below x
+add:
+	andcc	#$fe
+	ldb	#8
+.1	lda	,-x
+	adca	,-y
+	daa
+	sta	,x
+	decb
+	bne	.1
+	rts
+
+	section	VECTORS
+
+	dw	$0000,$0000,$0000,$0000,$0000,$0000,$0000,vector_reset
@@ -0,0 +1,69 @@
+; bubble.s - bubble sort
+;
+; Sorts 512 bytes from an 8 bit lcg (x = 5 * x + 17), unsigned. The
+; result is a Fletcher style checksum of the sorted data, sum of sums
+; in the high word, sum in the low word.
+
+RESULT	equ	$0000
+LIMIT	equ	$0010
+SUM1	equ	$0012
+SUM2	equ	$0014
+DATA	equ	$2000
+SIZE	equ	512
+
+	section	TEXT
+
+vector_reset:
+	lds	#$1000
+	ldx	#DATA
+	ldb	#$5a
+.1	lda	#5
+	mul
+	addb	#17
+	stb	,x+
+	cmpx	#DATA+SIZE
+	blo	.1
+
+	; u points at the last element of the unsorted part
+	ldu	#DATA+SIZE-1
+outer:
+	stu	<LIMIT
+	ldx	#DATA
+inner:
+	lda	,x
+	cmpa	1,x
+	bls	.1
+	ldb	1,x
+	stb	,x
+	sta	1,x
+.1	leax	1,x
+	cmpx	<LIMIT
+	blo	inner
+	leau	-1,u
+	cmpu	#DATA
+	bhi	outer
+
+checksum:
+	ldd	#$0000
+	std	<SUM1
+	std	<SUM2
+	ldx	#DATA
+.1	ldb	,x+
+	clra
+	addd	<SUM1
+	std	<SUM1
+	addd	<SUM2
+	std	<SUM2
+	cmpx	#DATA+SIZE
+	blo	.1
+	ldd	<SUM2
+	std	<RESULT
+	ldd	<SUM1
+	std	<RESULT+2
+
+done:
+	bra	done
+
+	section	VECTORS
+
+	dw	$0000,$0000,$0000,$0000,$0000,$0000,$0000,vector_reset
@@ -0,0 +1,53 @@
+; crc16.s - CRC-16/CCITT-FALSE, bitwise
+;
+; Polynomial $1021, initial value $ffff, over 4096 bytes of generated
+; data, four passes. The result is the crc of the last pass.
+
+RESULT	equ	$0000
+PASSES	equ	$0010
+DATA	equ	$2000
+SIZE	equ	4096
+
+	section	TEXT
+
+vector_reset:
+	lds	#$1000
+	ldd	#$0000
+	std	<RESULT
+	std	<RESULT+2
+	lda	#4
+	sta	<PASSES
+
+	; data[i] = 7 + 29 * i
+	ldx	#DATA
+	ldb	#7
+.1	stb	,x+
+	addb	#29
+	cmpx	#DATA+SIZE
+	blo	.1
+
+pass:
+	ldx	#DATA
+	ldd	#$ffff
+byte:
+	eora	,x+
+	ldy	#8
+.1	aslb
+	rola
+	bcc	.2
+	eora	#$10
+	eorb	#$21
+.2	leay	-1,y
+	bne	.1
+	cmpx	#DATA+SIZE
+	blo	byte
+	std	<RESULT+2
+	dec	<PASSES
+	bne	pass
+
+done:
+	bra	done
+
+	section	VECTORS
+
+	dw	$0000,$0000,$0000,$0000,$0000,$0000,$0000,vector_reset
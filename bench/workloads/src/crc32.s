@@ -0,0 +1,72 @@
+; crc32.s - CRC-32 (reflected), bitwise
+;
+; Polynomial $edb88320, initial value and final xor $ffffffff, over
+; 2048 bytes of generated data, two passes. The crc is kept in the
+; direct page, most significant byte first.
+
+RESULT	equ	$0000
+PASSES	equ	$0010
+CRC	equ	$0020
+DATA	equ	$2000
+SIZE	equ	2048
+
+	section	TEXT
+
+vector_reset:
+	lds	#$1000
+	lda	#2
+	sta	<PASSES
+
+	; data[i] = 7 + 29 * i
+	ldx	#DATA
+	ldb	#7
+.1	stb	,x+
+	addb	#29
+	cmpx	#DATA+SIZE
+	blo	.1
+
+pass:
+	ldx	#DATA
+	ldd	#$ffff
+	std	<CRC
+	std	<CRC+2
+byte:
+	lda	,x+
+	eora	<CRC+3
+	sta	<CRC+3
+	ldy	#8
+.1	lsr	<CRC
+	ror	<CRC+1
+	ror	<CRC+2
+	ror	<CRC+3
+	bcc	.2
+	ldd	<CRC
+	eora	#$ed
+	eorb	#$b8
+	std	<CRC
+	ldd	<CRC+2
+	eora	#$83
+	eorb	#$20
+	std	<CRC+2
+.2	leay	-1,y
+	bne	.1
+	cmpx	#DATA+SIZE
+	blo	byte
+
+	ldd	<CRC
+	coma
+	comb
+	std	<RESULT
+	ldd	<CRC+2
+	coma
+	comb
+	std	<RESULT+2
+	dec	<PASSES
+	bne	pass
+
+done:
+	bra	done
+
+	section	VECTORS
+
+	dw	$0000,$0000,$0000,$0000,$0000,$0000,$0000,vector_reset
@@ -0,0 +1,62 @@
+; memcpy.s - block copies
+;
+; Copies 4096 bytes with lda ,x+ / sta ,y+ and copies the copy with
+; ldd ,x++ / std ,y++, 32 passes. The result is the 16 bit sum of the
+; bytes in the final block.
+
+RESULT	equ	$0000
+PASSES	equ	$0010
+SOURCE	equ	$2000
+BLOCK1	equ	$4000
+BLOCK2	equ	$6000
+SIZE	equ	4096
+
+	section	TEXT
+
+vector_reset:
+	lds	#$1000
+	ldd	#$0000
+	std	<RESULT
+	std	<RESULT+2
+	lda	#32
+	sta	<PASSES
+
+	; source[i] = 1 + 3 * i
+	ldx	#SOURCE
+	ldb	#1
+.1	stb	,x+
+	addb	#3
+	cmpx	#SOURCE+SIZE
+	blo	.1
+
+pass:
+	ldx	#SOURCE
+	ldy	#BLOCK1
+.1	lda	,x+
+	sta	,y+
+	cmpx	#SOURCE+SIZE
+	blo	.1
+
+	ldx	#BLOCK1
+	ldy	#BLOCK2
+.2	ldd	,x++
+	std	,y++
+	cmpx	#BLOCK1+SIZE
+	blo	.2
+	dec	<PASSES
+	bne	pass
+
+	ldx	#BLOCK2
+	ldd	#$0000
+.3	addb	,x+
+	adca	#0
+	cmpx	#BLOCK2+SIZE
+	blo	.3
+	std	<RESULT+2
+
+done:
+	bra	done
+
+	section	VECTORS
+
+	dw	$0000,$0000,$0000,$0000,$0000,$0000,$0000,vector_reset
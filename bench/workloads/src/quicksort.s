@@ -0,0 +1,97 @@
+; quicksort.s - recursive quicksort (Lomuto partition)
+;
+; Sorts 4096 bytes from an 8 bit lcg (x = 5 * x + 17), unsigned, two
+; passes. The result is the same checksum as in bubble.s.
+
+RESULT	equ	$0000
+PASSES	equ	$0010
+PIVOT	equ	$0011
+SUM1	equ	$0012
+SUM2	equ	$0014
+DATA	equ	$2000
+SIZE	equ	4096
+
+	section	TEXT
+
+vector_reset:
+	lds	#$1000
+	lda	#2
+	sta	<PASSES
+
+pass:
+	ldx	#DATA
+	ldb	#$5a
+.1	lda	#5
+	mul
+	addb	#17
+	stb	,x+
+	cmpx	#DATA+SIZE
+	blo	.1
+
+	ldx	#DATA
+	ldy	#DATA+SIZE-1
+	bsr	qsort
+	dec	<PASSES
+	bne	pass
+	bra	checksum
+
+; Sorts x..y (inclusive). The pivot is the last element, u is where
+; the next element smaller than the pivot goes.
+qsort:
+	pshs	y
+	cmpx	,s++
+	bhs	.3
+	lda	,y
+	sta	<PIVOT
+	tfr	x,u
+	pshs	x,y
+.1	cmpx	2,s
+	bhs	.2
+	ldb	,x
+	cmpb	<PIVOT
+	bhs	.4
+	lda	,u
+	stb	,u+
+	sta	,x
+.4	leax	1,x
+	bra	.1
+.2	ldy	2,s
+	lda	,u
+	ldb	,y
+	stb	,u
+	sta	,y
+	ldx	,s
+	leay	-1,u
+	pshs	u
+	bsr	qsort
+	puls	u
+	leax	1,u
+	ldy	2,s
+	bsr	qsort
+	leas	4,s
+.3	rts
+
+checksum:
+	ldd	#$0000
+	std	<SUM1
+	std	<SUM2
+	ldx	#DATA
+.1	ldb	,x+
+	clra
+	addd	<SUM1
+	std	<SUM1
+	addd	<SUM2
+	std	<SUM2
+	cmpx	#DATA+SIZE
+	blo	.1
+	ldd	<SUM2
+	std	<RESULT
+	ldd	<SUM1
+	std	<RESULT+2
+
+done:
+	bra	done
+
+	section	VECTORS
+
+	dw	$0000,$0000,$0000,$0000,$0000,$0000,$0000,vector_reset
@@ -0,0 +1,68 @@
+; sieve.s - sieve of Eratosthenes
+;
+; Flags for 0..8191, eight passes. The result is the number of primes
+; found, summed over the passes (8 * 1028).
+
+RESULT	equ	$0000
+PASSES	equ	$0010
+FLAGS	equ	$2000
+SIZE	equ	8192
+
+	section	TEXT
+
+vector_reset:
+	lds	#$1000
+	ldd	#$0000
+	std	<RESULT
+	std	<RESULT+2
+	lda	#8
+	sta	<PASSES
+
+pass:
+	ldx	#FLAGS
+	ldd	#$0101
+.1	std	,x++
+	cmpx	#FLAGS+SIZE
+	blo	.1
+
+	; u holds i, stops when i * i >= SIZE
+	ldu	#2
+prime:
+	tfr	u,d
+	tfr	b,a
+	mul
+	cmpd	#SIZE
+	bhs	count
+	leax	FLAGS,u
+	tst	,x
+	beq	.2
+	ldx	#FLAGS
+	leax	d,x
+.1	clr	,x
+	tfr	u,d
+	leax	d,x
+	cmpx	#FLAGS+SIZE
+	blo	.1
+.2	leau	1,u
+	bra	prime
+
+count:
+	ldx	#FLAGS+2
+	ldy	#$0000
+.1	tst	,x+
+	beq	.2
+	leay	1,y
+.2	cmpx	#FLAGS+SIZE
+	blo	.1
+	tfr	y,d
+	addd	<RESULT+2
+	std	<RESULT+2
+	dec	<PASSES
+	bne	pass
+
+done:
+	bra	done
+
+	section	VECTORS
+
+	dw	$0000,$0000,$0000,$0000,$0000,$0000,$0000,vector_reset
@@ -0,0 +1,53 @@
+; timer.s - irq heavy timer loop
+;
+; The host asserts irq every 100 cycles, a write to TIMER_ACK releases
+; it. The handler counts 20000 ticks and sums the tick numbers, the
+; main loop waits for the last one. The result is 20000 * 20001 / 2.
+
+RESULT	equ	$0000
+TICKS	equ	$0010
+SUM	equ	$0012
+TIMER_ACK	equ	$df00
+LAST	equ	20000
+
+	section	TEXT
+
+vector_reset:
+	lds	#$1000
+	ldd	#$0000
+	std	<TICKS
+	std	<SUM
+	std	<SUM+2
+	andcc	#$ef
+
+wait:
+	ldd	<TICKS
+	cmpd	#LAST
+	blo	wait
+	orcc	#$10
+	ldd	<SUM
+	std	<RESULT
+	ldd	<SUM+2
+	std	<RESULT+2
+
+done:
+	bra	done
+
+vector_irq:
+	clr	TIMER_ACK
+	ldd	<TICKS
+	cmpd	#LAST
+	bhs	.1
+	addd	#1
+	std	<TICKS
+	addd	<SUM+2
+	std	<SUM+2
+	ldd	<SUM
+	adcb	#0
+	adca	#0
+	std	<SUM
+.1	rti
+
+	section	VECTORS
+
+	dw	$0000,$0000,$0000,$0000,vector_irq,$0000,$0000,vector_reset
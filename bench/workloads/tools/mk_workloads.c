@@ -0,0 +1,80 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Images are 8k, $e000-$ffff, the last 16 bytes are the vectors. Only
+ * the code up to the last non zero byte goes into the cpp file.
+ */
+int main(int argc, char *argv[]) {
+	time_t t;
+	time(&t);
+
+	if (argc < 3) {
+		printf("[mk_workloads] usage: mk_workloads output.cpp name...\n");
+		return 1;
+	}
+
+	FILE *out = fopen(argv[1], "w");
+	if (out == NULL) {
+		printf("[mk_workloads] can't write %s\n", argv[1]);
+		return 1;
+	}
+
+	fprintf(out, "/*\n");
+	fprintf(out, " * mc6809_bench (workloads.cpp) elmerucr (c)2026\n");
+	fprintf(out, " *\n");
+	fprintf(out, " * workload images for mc6809_bench, generated by bench/workloads\n");
+	fprintf(out, " * %s", ctime(&t));
+	fprintf(out, " */\n\n");
+	fprintf(out, "#include \"workloads.hpp\"\n");
+
+	for (int w = 2; w < argc; w++) {
+		uint8_t image[8192];
+		char name[256];
+		snprintf(name, sizeof(name), "%s.bin", argv[w]);
+
+		FILE *f = fopen(name, "rb");
+		if ((f == NULL) || (fread(image, 1, 8192, f) != 8192)) {
+			printf("[mk_workloads] %s missing or not 8k\n", name);
+			if (f) fclose(f);
+			fclose(out);
+			return 1;
+		}
+		fclose(f);
+
+		int size = 8192 - 16;
+		while ((size > 0) && (image[size - 1] == 0x00)) size--;
+		printf("[mk_workloads] %s: %i bytes of code\n", name, size);
+
+		fprintf(out, "\nstatic const uint8_t %s_code[%i] = {", argv[w], size);
+		for (int i = 0; i < size; i++) {
+			if (i%16 == 0) fprintf(out, "\n\t");
+			fprintf(out, "0x%02x%s", image[i], (i < size - 1) ? "," : "");
+		}
+		fprintf(out, "\n};\n");
+	}
+
+	fprintf(out, "\nconst struct workload workloads[] = {\n");
+	for (int w = 2; w < argc; w++) {
+		uint8_t vectors[16];
+		char name[256];
+		snprintf(name, sizeof(name), "%s.bin", argv[w]);
+
+		FILE *f = fopen(name, "rb");
+		fseek(f, 8192 - 16, SEEK_SET);
+		fread(vectors, 1, 16, f);
+		fclose(f);
+
+		fprintf(out, "\t{ \"%s\", %s_code, sizeof(%s_code), {", argv[w], argv[w], argv[w]);
+		for (int i = 0; i < 16; i++) {
+			fprintf(out, "%s0x%02x", i ? "," : " ", vectors[i]);
+		}
+		fprintf(out, " } },\n");
+	}
+	fprintf(out, "\t{ NULL, NULL, 0, { 0 } }\n");
+	fprintf(out, "};\n");
+
+	fclose(out);
+	return 0;
+}
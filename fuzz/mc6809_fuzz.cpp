@@ -0,0 +1,314 @@
+/*
+ * mc6809_fuzz.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * In-process fuzz harness for guest code, driven by edge coverage.
+ *
+ * The routine under test is called with x pointing to the input (at
+ * FUZZ_INPUT) and d holding its length. It is done when it returns
+ * (rts to the sentinel address $0000) or when the cycle budget is
+ * exhausted. An illegal opcode counts as a crash.
+ *
+ * Environment:
+ *   MC6809_FUZZ_ROM      binary image, loaded so it ends at $ffff
+ *                        (default: a small built-in demo parser)
+ *   MC6809_FUZZ_ENTRY    hex address of the routine (default: start
+ *                        of the image)
+ *   MC6809_FUZZ_CYCLES   cycle budget per input (default 1000000)
+ *
+ * Built with -DMC6809_LIBFUZZER (clang -fsanitize=fuzzer) this file is
+ * a libFuzzer target, the edge map goes into libFuzzer's extra
+ * counters. Otherwise it contains a small standalone coverage guided
+ * fuzzer: mc6809_fuzz [-runs=N] [-max_len=N] [seed files...]
+ */
+
+#include "mc6809.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#define	FUZZ_INPUT	0x1000
+#define	FUZZ_MAX_LEN	0x1000
+#define	FUZZ_STACK	0x0ffe
+
+static uint8_t memory[65536];
+static uint8_t pristine[65536];
+
+class cpu_t : public mc6809 {
+public:
+	uint8_t read8(uint16_t address) const { return memory[address]; }
+	void write8(uint16_t address, uint8_t value) const {
+		if (address < rom_start) memory[address] = value;
+	}
+	uint32_t rom_start;
+};
+
+/*
+ * Demo routine: crashes (illegal opcode) on input starting with "FUZ!"
+ */
+static const uint8_t demo_rom[] = {
+	0x10, 0x83, 0x00, 0x04,		// e000 cmpd  #4
+	0x25, 0x19,			// e004 blo   done
+	0xa6, 0x80,			// e006 lda   ,x+
+	0x81, 'F',			// e008 cmpa  #'F'
+	0x26, 0x13,			// e00a bne   done
+	0xa6, 0x80,			// e00c lda   ,x+
+	0x81, 'U',			// e00e cmpa  #'U'
+	0x26, 0x0d,			// e010 bne   done
+	0xa6, 0x80,			// e012 lda   ,x+
+	0x81, 'Z',			// e014 cmpa  #'Z'
+	0x26, 0x07,			// e016 bne   done
+	0xa6, 0x80,			// e018 lda   ,x+
+	0x81, '!',			// e01a cmpa  #'!'
+	0x26, 0x01,			// e01c bne   done
+	0x01,				// e01e illegal
+	0x39				// e01f done: rts
+};
+
+static cpu_t *cpu;
+static struct mc6809_snapshot initial_state;
+static uint16_t entry;
+static uint32_t cycle_budget = 1000000;
+
+static bool setup(uint8_t *edge_map)
+{
+	uint32_t size = sizeof(demo_rom);
+	const uint8_t *image = demo_rom;
+	std::vector<uint8_t> file;
+
+	if (const char *name = getenv("MC6809_FUZZ_ROM")) {
+		FILE *f = fopen(name, "rb");
+		if (f == NULL) {
+			fprintf(stderr, "error: can't open %s\n", name);
+			return false;
+		}
+		int c;
+		while (((c = fgetc(f)) != EOF) && (file.size() < 0xc000)) file.push_back(c);
+		fclose(f);
+		size = file.size();
+		image = file.data();
+	}
+
+	cpu = new cpu_t;
+	cpu->rom_start = 0x10000 - size;
+	memcpy(&memory[cpu->rom_start], image, size);
+	if (image == demo_rom) {
+		memory[0xfffe] = 0xe0;
+		memory[0xffff] = 0x00;
+		cpu->rom_start = 0xe000;
+		memcpy(&memory[0xe000], demo_rom, sizeof(demo_rom));
+	}
+	memcpy(pristine, memory, sizeof(memory));
+
+	entry = cpu->rom_start;
+	if (const char *e = getenv("MC6809_FUZZ_ENTRY")) entry = strtol(e, NULL, 16);
+	if (const char *c = getenv("MC6809_FUZZ_CYCLES")) cycle_budget = strtoul(c, NULL, 0);
+
+	cpu->set_illegal_opcode_mode(ILLEGAL_OPCODE_STOP);
+	cpu->enable_edge_coverage(true, edge_map);
+	cpu->reset();
+	cpu->save_snapshot(&initial_state);
+	return true;
+}
+
+/*
+ * Runs one input, returns true on a crash. Only ram is restored, the
+ * rom part of memory is never written.
+ */
+static bool run(const uint8_t *data, size_t size)
+{
+	if (size > FUZZ_MAX_LEN) size = FUZZ_MAX_LEN;
+
+	memcpy(memory, pristine, cpu->rom_start);
+	memcpy(&memory[FUZZ_INPUT], data, size);
+	memory[FUZZ_STACK] = 0x00;
+	memory[FUZZ_STACK + 1] = 0x00;
+
+	cpu->restore_snapshot(&initial_state);
+	cpu->set_pc(entry);
+	cpu->set_sp(FUZZ_STACK);
+	cpu->set_xr(FUZZ_INPUT);
+	cpu->set_dr(size);
+
+	uint32_t cycles = 0;
+	while ((cpu->get_pc() != 0x0000) && (cycles < cycle_budget) && !cpu->stopped()) {
+		cycles += cpu->execute();
+	}
+	return cpu->stopped();
+}
+
+#ifdef MC6809_LIBFUZZER
+
+__attribute__((section("__libfuzzer_extra_counters")))
+static uint8_t edge_counters[EDGE_MAP_SIZE];
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+	return setup(edge_counters) ? 0 : 1;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	if (run(data, size)) abort();
+	return 0;
+}
+
+#else
+
+static uint32_t random_state = 0x6809;
+
+static uint32_t random_number(uint32_t n)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state % n;
+}
+
+static void mutate(std::vector<uint8_t> &input, size_t max_len)
+{
+	static const uint8_t interesting[] = { 0x00, 0x01, 0x7f, 0x80, 0xff };
+	int mutations = 1 + random_number(4);
+
+	while (mutations--) {
+		switch (input.empty() ? 2 : random_number(5)) {
+		case 0:
+			input[random_number(input.size())] ^= 1 << random_number(8);
+			break;
+		case 1:
+			input[random_number(input.size())] = random_number(256);
+			break;
+		case 2:
+			if (input.size() < max_len) {
+				input.insert(input.begin() + random_number(input.size() + 1),
+					random_number(256));
+			}
+			break;
+		case 3:
+			input.erase(input.begin() + random_number(input.size()));
+			break;
+		case 4:
+			input[random_number(input.size())] =
+				interesting[random_number(sizeof(interesting))];
+			break;
+		}
+	}
+}
+
+/*
+ * AFL hit count buckets
+ */
+static uint8_t bucket(uint8_t count)
+{
+	if (count == 0) return 0;
+	if (count < 4) return 1 << (count - 1);
+	if (count < 8) return 0x08;
+	if (count < 16) return 0x10;
+	if (count < 32) return 0x20;
+	if (count < 128) return 0x40;
+	return 0x80;
+}
+
+static bool new_coverage(const uint8_t *map, uint8_t *virgin)
+{
+	bool found = false;
+	const uint64_t *words = (const uint64_t *)map;
+	for (int i=0; i<EDGE_MAP_SIZE; i++) {
+		/*
+		 * Most of the map is empty, skip it 8 bytes at a time
+		 */
+		if (((i & 7) == 0) && (words[i >> 3] == 0)) {
+			i += 7;
+			continue;
+		}
+		if (map[i]) {
+			uint8_t b = bucket(map[i]);
+			if (b & virgin[i]) {
+				virgin[i] &= ~b;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+static void save_crash(const std::vector<uint8_t> &input)
+{
+	char name[32];
+	uint32_t hash = 2166136261u;
+	for (uint8_t b : input) hash = (hash ^ b) * 16777619u;
+	snprintf(name, sizeof(name), "crash-%08x", hash);
+	FILE *f = fopen(name, "wb");
+	if (f) {
+		fwrite(input.data(), 1, input.size(), f);
+		fclose(f);
+	}
+	printf("==%s== illegal opcode at $%04x, input written to %s\n",
+		"mc6809_fuzz", cpu->get_pc(), name);
+}
+
+int main(int argc, char **argv)
+{
+	uint64_t runs = 1000000;
+	size_t max_len = 256;
+	std::vector<std::vector<uint8_t>> corpus;
+
+	for (int i=1; i<argc; i++) {
+		if (strncmp(argv[i], "-runs=", 6) == 0) {
+			runs = strtoull(argv[i] + 6, NULL, 10);
+		} else if (strncmp(argv[i], "-max_len=", 9) == 0) {
+			max_len = strtoul(argv[i] + 9, NULL, 10);
+			if (max_len > FUZZ_MAX_LEN) max_len = FUZZ_MAX_LEN;
+		} else {
+			FILE *f = fopen(argv[i], "rb");
+			if (f == NULL) continue;
+			std::vector<uint8_t> seed;
+			int c;
+			while (((c = fgetc(f)) != EOF) && (seed.size() < max_len)) seed.push_back(c);
+			fclose(f);
+			corpus.push_back(seed);
+		}
+	}
+	if (corpus.empty()) corpus.push_back(std::vector<uint8_t>());
+
+	if (!setup(NULL)) return 1;
+
+	uint8_t *map = cpu->get_edge_map();
+	uint8_t *virgin = new uint8_t[EDGE_MAP_SIZE];
+	memset(virgin, 0xff, EDGE_MAP_SIZE);
+
+	auto start = std::chrono::steady_clock::now();
+	int exit_code = 0;
+	uint64_t run_number;
+
+	for (run_number=0; run_number<runs; run_number++) {
+		std::vector<uint8_t> input = corpus[random_number(corpus.size())];
+		if (run_number >= corpus.size()) mutate(input, max_len);
+
+		cpu->reset_edge_coverage();
+		if (run(input.data(), input.size())) {
+			save_crash(input);
+			exit_code = 1;
+			run_number++;
+			break;
+		}
+		if (new_coverage(map, virgin)) corpus.push_back(input);
+	}
+
+	double seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+	int edges = 0;
+	for (int i=0; i<EDGE_MAP_SIZE; i++) if (virgin[i] != 0xff) edges++;
+	printf("#%llu runs in %.2fs (%.0f exec/s), corpus %zu, edges %i\n",
+		(unsigned long long)run_number, seconds, run_number / seconds,
+		corpus.size(), edges);
+
+	delete [] virgin;
+	delete cpu;
+	return exit_code;
+}
+
+#endif
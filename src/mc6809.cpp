@@ -10,6 +10,7 @@
 mc6809::mc6809()
 {
 	cc = 0b00000000;
+	pc = 0x0000;
 
 	/*
 	 * When NFI pins are not (yet) assigned, there needs to be a
@@ -22,14 +23,56 @@ mc6809::mc6809()
 
 	cycles = 0;
 
-	index_regs[0b00] = &xr;
-	index_regs[0b01] = &yr;
-	index_regs[0b10] = &us;
-	index_regs[0b11] = &sp;
+	hle_bitmap = NULL;
 
-	breakpoint_array = NULL;
-	breakpoint_array = new bool[65536];
-	clear_breakpoints();
+	instruments = 0;
+	profile_instructions = NULL;
+	profile_cycles = NULL;
+	reset_statistics();
+	callgraph_self_cycles = NULL;
+	callgraph_owner = NULL;
+	callgraph_cycles = 0;
+	sampler_period = 0;
+	sampler_countdown = INT32_MAX;
+	sampler_random = 0x6809;
+	samples = NULL;
+	sampler_stacks = 0;
+	samples_dropped = 0;
+	trace_buffer = NULL;
+	trace_mask = 0;
+	trace_head = 0;
+	trace_cycles = 0;
+	stream = NULL;
+	stream_next = NULL;
+	stream_end = NULL;
+	coverage_executed = NULL;
+	edge_map = NULL;
+	edge_map_owned = false;
+	edge_previous = 0;
+	heat_reads = NULL;
+	reset_interrupt_latency();
+
+	illegal_opcode_mode = ILLEGAL_OPCODE_EXCEPTION;
+	illegal_callback = NULL;
+	illegal_callback_data = NULL;
+	stop_reason = STOP_NONE;
+
+	syscall_gate = SYSCALL_GATE_OFF;
+	for (int i=0; i<256; i++) {
+		syscalls[i].function = NULL;
+		syscalls[i].data = NULL;
+	}
+	for (int i=0; i<SYSCALL_MAX_FILES; i++) {
+		syscall_files[i] = NULL;
+	}
+
+	breakpoint_bits = NULL;
+	breakpoints_armed = 0;
+	breakpoint_reached = false;
+	breakpoint_pc = 0;
+
+	clear_watchpoints();
+	watchpoint_triggered = false;
 
 	printf("[MC6809] version %i.%i.%i (C)%i elmerucr\n",
 	       MC6809_MAJOR_VERSION,
@@ -41,7 +84,21 @@ mc6809::mc6809()
 mc6809::~mc6809()
 {
 	printf("[MC6809] cleaning up\n");
-	delete breakpoint_array;
+	delete [] breakpoint_bits;
+	delete [] hle_bitmap;
+	delete [] profile_instructions;
+	delete [] profile_cycles;
+	delete [] callgraph_self_cycles;
+	delete [] callgraph_owner;
+	delete [] samples;
+	delete [] trace_buffer;
+	stop_trace_stream();
+	delete [] coverage_executed;
+	if (edge_map_owned) delete [] edge_map;
+	delete [] heat_reads;
+	for (int i=3; i<SYSCALL_MAX_FILES; i++) {
+		if (syscall_files[i]) fclose(syscall_files[i]);
+	}
 }
 
 void mc6809::reset()
@@ -69,6 +126,8 @@ void mc6809::reset()
 	 * set cpu status
 	 */
 	cpu_state = CPU_NORMAL;
+	stop_reason = STOP_NONE;
+	breakpoint_reached = false;
 
 	/*
 	 * Load program counter from vector
@@ -79,51 +138,201 @@ void mc6809::reset()
 }
 
 uint16_t mc6809::execute()
+{
+	/*
+	 * Two instantiations of the same loop body. When no instruments
+	 * are enabled, the plain one carries no instrumentation overhead.
+	 */
+	if (instruments) {
+		return step<true>();
+	} else {
+		return step<false>();
+	}
+}
+
+/*
+ * Page 1 opcodes that can change the flow of control, used for edge
+ * coverage. The $10 and $11 prefixes are included, their pages hold the
+ * long conditional branches and swi2/swi3.
+ */
+static const bool control_flow_page1[256] = {
+//	0 1 2 3 4 5 6 7 8 9 a b c d e f
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,	// 0
+	1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,	// 1
+	1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,	// 2
+	0,0,0,0,0,1,0,1,0,1,0,1,1,0,0,1,	// 3
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,	// 4
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,	// 5
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,	// 6
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,	// 7
+	0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,	// 8
+	0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,	// 9
+	0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,	// a
+	0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,	// b
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,	// c
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,	// d
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,	// e
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0	// f
+};
+
+template <bool instrumented>
+uint16_t mc6809::step()
 {
 	uint32_t old_cycles = cycles;
 
+	watchpoint_triggered = false;
+
+	if (cpu_state == CPU_STOPPED) {
+		/*
+		 * Nothing happens until the next reset
+		 */
+		return 0;
+	}
+
+	instruction_pc = pc;
+	fetched_bytes = 0;
+
+	/*
+	 * Only used by the instrumented instantiation
+	 */
+	uint16_t old_sp = sp;
+	uint8_t old_cc = cc;
+	enum statistics_interrupt_t interrupt = STAT_INTERRUPTS;
+	bool control_flow = true;
+	bool waiting = false;	// sync or cwai, no instruction runs
+
+	if (instrumented && (instruments & INSTRUMENT_LATENCY)) latency_lines();
+
 	if ((*nmi_line == false) && (old_nmi_line == true) && nmi_enabled) {
 		cpu_state = CPU_NORMAL;
+		interrupt = STAT_NMI;
 		nmi();
 	} else if ((*firq_line == false) && is_f_flag_clear()) {
 		cpu_state = CPU_NORMAL;
+		interrupt = STAT_FIRQ;
 		firq();
 	} else if ((*irq_line == false) && is_i_flag_clear()) {
 		cpu_state = CPU_NORMAL;
+		interrupt = STAT_IRQ;
 		irq();
 	} else {
 		if (cpu_state == CPU_NORMAL) {
-			uint8_t opcode = read8(pc++);
-			/*
-			* TODO: check for illegal opcode and start exception
-			*/
-			cycles += cycles_page1[opcode];
-			bool am_legal;
-			uint16_t effective_address = (this->*addressing_modes_page1[opcode])(&am_legal);
-			(this->*opcodes_page1[opcode])(effective_address);
+			if (!hle_hooks.empty() && hle_hooked(pc) && run_hle_hook()) {
+				/*
+				 * Routine was handled by the host, rts and
+				 * cycles are already done.
+				 */
+			} else {
+				opcode = fetch8();
+				if (instrumented) control_flow = control_flow_page1[opcode];
+				cycles += opcode_table.cycles[0][opcode];
+				(this->*opcode_table.execute[0][opcode])();
+			}
 		} else if (cpu_state == CPU_SYNC) {
+			control_flow = false;
+			waiting = true;
 			cycles += SYNC_CYCLES;
 		} else {
 			// TODO: fixme
 			// for status CWAI????
+			control_flow = false;
+			waiting = true;
 			cycles += CWAI_CYCLES;
 		}
 	}
 
 	old_nmi_line = *nmi_line;
+
+	/*
+	 * Breakpoint conditions are only evaluated when the bit for the
+	 * new pc is armed.
+	 */
+	if (breakpoints_armed) {
+		breakpoint_reached = (breakpoint_bits[pc >> 3] & (1 << (pc & 0b111))) &&
+			check_breakpoint_condition();
+		breakpoint_pc = pc;
+	}
+
+	sampler_step(cycles - old_cycles);
+
+	if (instrumented) {
+		uint16_t consumed = cycles - old_cycles;
+		if ((instruments & INSTRUMENT_PROFILER) && (interrupt == STAT_INTERRUPTS) && !waiting)
+			profile_instruction(consumed);
+		if (instruments & INSTRUMENT_STATISTICS) {
+			if (interrupt != STAT_INTERRUPTS) {
+				interrupt_counts[interrupt]++;
+			} else if (fetched_bytes) {
+				count_instruction();
+			}
+		}
+		if (instruments & INSTRUMENT_CALLGRAPH)
+			callgraph_step(consumed, old_sp, interrupt != STAT_INTERRUPTS);
+		if ((instruments & INSTRUMENT_EDGES) && control_flow) edge_step();
+		if ((instruments & INSTRUMENT_HEATMAP) && !waiting)
+			heatmap_step(interrupt != STAT_INTERRUPTS);
+		if (instruments & INSTRUMENT_LATENCY)
+			latency_step(consumed, old_cc, interrupt);
+		if ((instruments & INSTRUMENT_COVERAGE) && (interrupt == STAT_INTERRUPTS) && !waiting)
+			coverage_step();
+		if (instruments & (INSTRUMENT_TRACE | INSTRUMENT_TRACE_STREAM)) {
+			uint8_t type = interrupt == STAT_NMI ? TRACE_NMI :
+				interrupt == STAT_FIRQ ? TRACE_FIRQ :
+				interrupt == STAT_IRQ ? TRACE_IRQ :
+				waiting ? TRACE_WAIT : TRACE_INSTRUCTION;
+			if (instruments & INSTRUMENT_TRACE) trace_step(consumed, type);
+			if (instruments & INSTRUMENT_TRACE_STREAM) trace_stream_step(consumed, type);
+		}
+	}
+
 	return cycles - old_cycles;
 }
 
-void mc6809::toggle_breakpoint(uint16_t address)
+void mc6809::save_snapshot(struct mc6809_snapshot *snapshot)
 {
-	breakpoint_array[address] = !breakpoint_array[address];
+	snapshot->registers.pc = pc;
+	snapshot->registers.dp = dp;
+	snapshot->registers.ac = ac;
+	snapshot->registers.br = br;
+	snapshot->registers.xr = xr;
+	snapshot->registers.yr = yr;
+	snapshot->registers.us = us;
+	snapshot->registers.sp = sp;
+	snapshot->registers.cc = cc;
+	snapshot->cpu_state = cpu_state;
+	snapshot->stop_reason = stop_reason;
+	snapshot->nmi_enabled = nmi_enabled;
+	snapshot->old_nmi_line = old_nmi_line;
+	snapshot->cycles = cycles;
 }
 
-void mc6809::clear_breakpoints()
+void mc6809::restore_snapshot(const struct mc6809_snapshot *snapshot)
 {
-	for (int i=0; i<65536; i++) {
-		breakpoint_array[i] = false;
-	}
+	pc = snapshot->registers.pc;
+	dp = snapshot->registers.dp;
+	ac = snapshot->registers.ac;
+	br = snapshot->registers.br;
+	xr = snapshot->registers.xr;
+	yr = snapshot->registers.yr;
+	us = snapshot->registers.us;
+	sp = snapshot->registers.sp;
+	cc = snapshot->registers.cc;
+	cpu_state = snapshot->cpu_state;
+	stop_reason = snapshot->stop_reason;
+	nmi_enabled = snapshot->nmi_enabled;
+	old_nmi_line = snapshot->old_nmi_line;
+	cycles = snapshot->cycles;
+	breakpoint_reached = false;
+	watchpoint_triggered = false;
+}
+
+void mc6809::set_illegal_opcode_mode(enum illegal_opcode_mode_t mode,
+				     illegal_opcode_callback callback,
+				     void *data)
+{
+	illegal_opcode_mode = mode;
+	illegal_callback = callback;
+	illegal_callback_data = data;
 }
 
 void mc6809::nmi()
@@ -144,8 +353,8 @@ void mc6809::nmi()
 	set_i_flag();
 	set_f_flag();
 	pc = 0;
-	pc = read8(VECTOR_NMI) << 8;
-	pc |= read8(VECTOR_NMI+1);
+	pc = bus_read8(VECTOR_NMI) << 8;
+	pc |= bus_read8(VECTOR_NMI+1);
 
 	/*
 	 * TODO: Can't find this in the documentation
@@ -162,8 +371,8 @@ void mc6809::firq()
 	set_f_flag();
 	set_i_flag();
 	pc = 0;
-	pc = read8(VECTOR_FIRQ) << 8;
-	pc |= read8(VECTOR_FIRQ+1);
+	pc = bus_read8(VECTOR_FIRQ) << 8;
+	pc |= bus_read8(VECTOR_FIRQ+1);
 
 	/*
 	 * can't find this in the documentation
@@ -188,8 +397,8 @@ void mc6809::irq()
 	push_sp(cc);
 	set_i_flag();
 	pc = 0;
-	pc = read8(VECTOR_IRQ) << 8;
-	pc |= read8(VECTOR_IRQ+1);
+	pc = bus_read8(VECTOR_IRQ) << 8;
+	pc |= bus_read8(VECTOR_IRQ+1);
 
 	/*
 	 * can't find this in the documentation
@@ -215,8 +424,8 @@ void mc6809::illegal_opcode()
 	set_i_flag();
 	set_f_flag();
 	pc = 0;
-	pc = read8(VECTOR_ILL_OPC) << 8;
-	pc |= read8(VECTOR_ILL_OPC+1);
+	pc = bus_read8(VECTOR_ILL_OPC) << 8;
+	pc |= bus_read8(VECTOR_ILL_OPC+1);
 
 	/*
 	 * same as nmi number of cycles
@@ -4,6 +4,37 @@
  * (C)2021-2025 elmerucr
  */
 
+/*
+ * MC6809 version 0.18 - 20261018
+ *
+ * High level emulation (HLE) hooks
+ * Guest to host syscall gate ($11 $3e or swi3)
+ * Illegal opcode exception (vector at $fff0) or stop with host callback
+ * Breakpoints in a lazily allocated bitset, read/write watchpoints
+ * Conditional breakpoints
+ * Per pc profiler with hot-spot report
+ * Per opcode, indexed mode and interrupt statistics (csv/json)
+ * Call graph profiler with callgrind output, symbols from vlink map
+ * Sampling profiler with folded stack output
+ * Binary execution trace ring buffer, mc6809_trace decoder tool
+ * Streaming trace to mmap'd file, grown by a background thread
+ * Instruction and branch coverage, mergeable bitmaps, listing/summary
+ * AFL style edge coverage, snapshots, mc6809_fuzz harness
+ * Memory heatmap (pgm/csv) and bus accesses per opcode
+ * Interrupt latency and service time, masked periods
+ * mc6809_bench microbenchmarks (json output)
+ * Benchmark workloads in 6809 assembly (bench/workloads)
+ * daa bugfix, carry from the preceding addition was lost
+ * Hardware performance counters in mc6809_bench (perf_event_open)
+ * Regression gate against a baseline json, median/mad
+ * mc6809 library target, LTO, PGO and -march build options
+ * set_dr() bugfix, b register was always cleared
+ * Amalgamated build (MC6809_IMPLEMENTATION), mc6809_bench_unity
+ * Opcode tables generated from one constexpr specification
+ * Table driven indexed postbyte decoder
+ * One generic short and long branch on a shared condition table
+ */
+
   /*
  * MC6809 version 0.17 - 20250519
  *
@@ -53,11 +84,33 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <cstdio>
+#include <vector>
+#include <map>
+#include <utility>
 
 #define MC6809_MAJOR_VERSION	0
-#define MC6809_MINOR_VERSION	17
-#define MC6809_BUILD		20250519
-#define MC6809_YEAR		2025
+#define MC6809_MINOR_VERSION	18
+#define MC6809_BUILD		20261018
+#define MC6809_YEAR		2026
+
+/*
+ * Amalgamated build. Define MC6809_IMPLEMENTATION in exactly one
+ * translation unit before including this header, and the complete core
+ * is compiled into that unit (the mc6809 library isn't linked then).
+ * execute() stays an ordinary function, declared the same in every
+ * unit, but its definition is visible to the host loop there.
+ *
+ * MC6809_INLINE is for private members that are only called from
+ * mc6809.cpp: step() and the exception entries, force-inlined into
+ * execute() with gcc and clang. It doesn't depend on
+ * MC6809_IMPLEMENTATION, so every unit sees the same declaration.
+ */
+#if defined(__GNUC__)
+#define	MC6809_INLINE	inline __attribute__((always_inline))
+#else
+#define	MC6809_INLINE	inline
+#endif
 
 #define	C_FLAG	0x01	// carry
 #define	V_FLAG	0x02	// overflow
@@ -77,21 +130,222 @@
 #define	VECTOR_NMI	0xfffc
 #define	VECTOR_RESET	0xfffe
 
+/*
+ * Optional instruments, run by a separate instantiation of execute()
+ */
+#define	INSTRUMENT_PROFILER	0x00000001
+#define	INSTRUMENT_STATISTICS	0x00000002
+#define	INSTRUMENT_CALLGRAPH	0x00000004
+#define	INSTRUMENT_TRACE	0x00000010
+#define	INSTRUMENT_TRACE_STREAM	0x00000020
+#define	INSTRUMENT_COVERAGE	0x00000040
+#define	INSTRUMENT_EDGES	0x00000080
+#define	INSTRUMENT_HEATMAP	0x00000100
+#define	INSTRUMENT_LATENCY	0x00000200
+
+/*
+ * Interrupt latency histograms have log2 buckets: 0, 1, 2-3, 4-7, ...
+ * the last one holds everything from 2^(LATENCY_BUCKETS-2) cycles.
+ */
+#define	LATENCY_BUCKETS	18
+
+/*
+ * Size of the edge coverage map (AFL compatible)
+ */
+#define	EDGE_MAP_SIZE	65536
+
+#define	COVERAGE_MAGIC	"MC6809CV"
+
+/*
+ * Call graph shadow stack depth, older frames are dropped when full
+ */
+#define	CALLGRAPH_MAX_DEPTH	1024
+
+/*
+ * Pseudo function for everything executed outside any call
+ */
+#define	CALLGRAPH_ROOT		0x10000
+
+/*
+ * Sampling profiler: maximum number of return addresses per sample,
+ * number of stack bytes searched for them and number of slots in the
+ * table of distinct stacks (power of two, filled up to 3/4)
+ */
+#define	SAMPLER_MAX_DEPTH	8
+#define	SAMPLER_STACK_BYTES	32
+#define	SAMPLER_SLOTS		16384
+
+/*
+ * Interrupt vectors counted by the statistics
+ */
+enum statistics_interrupt_t {
+	STAT_NMI,
+	STAT_FIRQ,
+	STAT_IRQ,
+	STAT_SWI,
+	STAT_SWI2,
+	STAT_SWI3,
+	STAT_INTERRUPTS
+};
+
+/*
+ * Indexed postbyte classes: 0-15 are the low nibble of postbytes with
+ * bit 7 set, STAT_IDX_OFFSET5 is the 5 bit constant offset mode.
+ */
+#define	STAT_IDX_OFFSET5	16
+#define	STAT_IDX_CLASSES	17
+
+#define	WATCH_READ	0x01
+#define	WATCH_WRITE	0x02
+
+/*
+ * Heatmap access types, reads and writes share the watch flags
+ */
+#define	HEAT_READ	WATCH_READ
+#define	HEAT_WRITE	WATCH_WRITE
+#define	HEAT_FETCH	0x04
+
 #define SYNC_CYCLES	50
 #define CWAI_CYCLES	50
 
 enum cpu_state_t {
 	CPU_NORMAL = 0,
 	CPU_CWAI,
-	CPU_SYNC
+	CPU_SYNC,
+	CPU_STOPPED
 };
 
-const char cpu_state_description[3][5] = {
+const char cpu_state_description[4][5] = {
 	"run",
 	"hlt",
-	"hlt"
+	"hlt",
+	"stp"
+};
+
+/*
+ * Behaviour on illegal opcodes (and illegal indexed postbytes). Either
+ * an exception through the vector at $fff0 (from the 6309), or an
+ * immediate stop of the cpu without stacking anything. In the latter
+ * case pc points to the offending instruction.
+ */
+enum illegal_opcode_mode_t {
+	ILLEGAL_OPCODE_EXCEPTION = 0,
+	ILLEGAL_OPCODE_STOP
+};
+
+enum stop_reason_t {
+	STOP_NONE = 0,
+	STOP_ILLEGAL_OPCODE
+};
+
+/*
+ * Guest to host syscall gate. With SYSCALL_GATE_OPCODE, the otherwise
+ * illegal opcode $11 $3e (sys #imm) traps into the host. With
+ * SYSCALL_GATE_SWI3, swi3 followed by an immediate byte does the same
+ * instead of using the vector at $fff2. Nothing is stacked, so both
+ * gates cost SYSCALL_GATE_CYCLES plus what the host function returns.
+ */
+enum syscall_gate_t {
+	SYSCALL_GATE_OFF = 0,
+	SYSCALL_GATE_OPCODE,
+	SYSCALL_GATE_SWI3
 };
 
+#define SYSCALL_OPCODE		0x3e	// page 3
+#define SYSCALL_GATE_CYCLES	5
+
+/*
+ * Default syscalls, see install_default_syscalls(). Carry flag is set
+ * on error.
+ */
+#define SYSCALL_MEMFILL		0x00	// x=address, y=count, a=value
+#define SYSCALL_MEMCPY		0x01	// x=source, y=destination, u=count
+#define SYSCALL_CYCLES		0x02	// returns clock_ticks in d (msw) and x (lsw)
+#define SYSCALL_HOST_TIME	0x03	// returns host ms in d (msw) and x (lsw)
+#define SYSCALL_OPEN		0x10	// x=filename, a=mode (0=r 1=w 2=a), returns handle in b
+#define SYSCALL_CLOSE		0x11	// b=handle
+#define SYSCALL_READ		0x12	// b=handle, x=buffer, y=count, returns count in y
+#define SYSCALL_WRITE		0x13	// b=handle, x=buffer, y=count, returns count in y
+
+#define SYSCALL_MAX_FILES	16	// handles 0, 1 and 2 are stdin, stdout and stderr
+
+/*
+ * Registers marshalled into a struct for syscall functions
+ */
+struct mc6809_registers {
+	uint16_t pc;
+	uint8_t  dp;
+	uint8_t  ac;
+	uint8_t  br;
+	uint16_t xr;
+	uint16_t yr;
+	uint16_t us;
+	uint16_t sp;
+	uint8_t  cc;
+};
+
+/*
+ * Binary execution trace. One fixed size record per executed
+ * instruction, interrupt entry or sync/cwai wait step, registers as
+ * they are after it. The
+ * cycle count is delta encoded, the file header holds the cycle count
+ * before the first record.
+ */
+#define	TRACE_MAGIC	"MC6809TR"
+#define	TRACE_VERSION	2
+
+#define	TRACE_INSTRUCTION	0
+#define	TRACE_NMI	1
+#define	TRACE_FIRQ	2
+#define	TRACE_IRQ	3
+#define	TRACE_WAIT	4	// sync or cwai, pc is where it resumes
+
+struct mc6809_trace_header {
+	char     magic[8];
+	uint32_t version;
+	uint32_t record_size;
+	uint64_t records;
+	uint64_t base_cycles;
+};
+
+struct mc6809_trace_record {
+	uint16_t pc;
+	uint16_t xr;
+	uint16_t yr;
+	uint16_t us;
+	uint16_t sp;
+	uint8_t  bytes[5];	// instruction bytes as fetched, 0 padded
+	uint8_t  type;		// TRACE_INSTRUCTION or interrupt entry
+	uint8_t  ac;
+	uint8_t  br;
+	uint8_t  dp;
+	uint8_t  cc;
+	uint16_t cycles;	// consumed by this record
+};
+
+/*
+ * Cpu state for fast save/restore (fuzzing, snapshots). Memory is up
+ * to the host.
+ */
+struct mc6809_snapshot {
+	struct mc6809_registers registers;
+	enum cpu_state_t cpu_state;
+	enum stop_reason_t stop_reason;
+	bool nmi_enabled;
+	bool old_nmi_line;
+	uint32_t cycles;
+};
+
+struct mc6809_latency_stats {
+	uint64_t count;
+	uint64_t min;
+	uint64_t max;
+	uint64_t total;
+	uint64_t histogram[LATENCY_BUCKETS];
+};
+
+class trace_stream;
+
 class mc6809 {
 public:
 	mc6809();
@@ -125,6 +379,7 @@ public:
 	void status(char *text_buffer, int n);
 	void stacks(char *text_buffer, int n, int no);
 	uint16_t disassemble_instruction(char *buffer, size_t n, uint16_t address);
+	const char *opcode_mnemonic(int page, uint8_t opcode);
 	bool disassemble_successfull() { return disassemble_success; }
 
 	inline bool is_e_flag_set()   { return (cc & E_FLAG) ? true  : false; }
@@ -181,7 +436,7 @@ public:
 	uint8_t  get_br()              { return br; }
 	void     set_br(uint8_t  byte) { br = byte; }
 	uint16_t get_dr()              { return (ac << 8) | br; }
-	void     set_dr(uint16_t word) { ac = (word & 0xff00) >> 8; br = word & 0x00; }
+	void     set_dr(uint16_t word) { ac = (word & 0xff00) >> 8; br = word & 0x00ff; }
 	uint16_t get_xr()              { return xr; }
 	void     set_xr(uint16_t word) { xr = word; }
 	uint16_t get_yr()              { return yr; }
@@ -193,13 +448,232 @@ public:
 	uint8_t  get_cc()              { return cc; }
 	void     set_cc(uint8_t  byte) { cc = byte; }
 
-	bool *breakpoint_array;
-	inline bool breakpoint() { return breakpoint_array[pc] ? true : false; }
+	/*
+	 * Breakpoints are kept in a bitset (8kb) that is only allocated
+	 * when the first breakpoint is set. The armed counter keeps
+	 * breakpoint() and the check at the end of execute() down to a
+	 * single test when no breakpoints are set. breakpoint() tells if
+	 * there's a breakpoint at the current pc. For a conditional one,
+	 * the condition must also have been met when execute() arrived
+	 * there.
+	 */
+	inline bool breakpoint() {
+		return breakpoints_armed &&
+			(breakpoint_bits[pc >> 3] & (1 << (pc & 0b111))) &&
+			(breakpoint_conditions.empty() || breakpoint_condition_met());
+	}
+	bool is_breakpoint(uint16_t address);
 	void toggle_breakpoint(uint16_t address);
 	void clear_breakpoints();
 
+	/*
+	 * Conditional breakpoints. The condition is compiled once into a
+	 * compact bytecode, and only evaluated when pc arrives at the armed
+	 * address. Returns false on a syntax error. Example:
+	 *
+	 *   "x>$2000 && [$0400]==0 && cc.z && hits>100"
+	 *
+	 * Operands:  pc a b d x y u s dp cc, flags cc.e cc.f cc.h cc.i cc.n
+	 *            cc.z cc.v cc.c, hits (number of arrivals at the
+	 *            address, including the current one), [operand] for a
+	 *            memory byte, numbers as $hex or decimal
+	 * Operators: ( ) ! & == != < <= > >= && ||
+	 */
+	bool set_conditional_breakpoint(uint16_t address, const char *condition);
+	const char *get_breakpoint_condition(uint16_t address);
+
+	/*
+	 * Watchpoints on address ranges (start and end inclusive). Like
+	 * breakpoints, watchpoint() must be checked inbetween calls to
+	 * execute(). It returns true if a watched access happened during
+	 * the last instruction. Details are available with
+	 * get_watchpoint_hit(). Watching is done with page granularity,
+	 * accesses to unwatched pages pay no extra cost.
+	 */
+	void add_watchpoint(uint16_t start, uint16_t end, uint8_t type);
+	void remove_watchpoint(uint16_t start, uint16_t end);
+	void clear_watchpoints();
+	inline bool watchpoint() { return watchpoint_triggered; }
+	struct watchpoint_hit {
+		uint16_t pc;		// instruction that made the access
+		uint16_t address;
+		uint8_t  value;
+		uint8_t  type;		// WATCH_READ or WATCH_WRITE
+	};
+	const struct watchpoint_hit &get_watchpoint_hit() { return watch_hit; }
+
 	inline uint32_t clock_ticks() { return cycles; }
 
+	/*
+	 * High level emulation (HLE) hooks. When pc reaches a hooked address,
+	 * the host function is called instead of the guest routine. The
+	 * function has access to registers (getters and setters) and memory
+	 * (read8 and write8). If it returns true, an rts is performed and
+	 * the configured number of cycles is charged. Returning false lets
+	 * the guest routine run as usual.
+	 */
+	typedef bool (*hle_function)(mc6809 *cpu, void *data);
+	void register_hle_hook(uint16_t address, hle_function function,
+			       uint16_t hook_cycles, void *data = NULL);
+	void unregister_hle_hook(uint16_t address);
+	void clear_hle_hooks();
+
+	/*
+	 * Syscall gate. A syscall function gets the registers, may change
+	 * them and returns the number of extra cycles consumed.
+	 */
+	typedef uint16_t (*syscall_function)(mc6809 *cpu,
+		struct mc6809_registers *regs, void *data);
+	void set_syscall_gate(enum syscall_gate_t gate) { syscall_gate = gate; }
+	enum syscall_gate_t get_syscall_gate() { return syscall_gate; }
+	void register_syscall(uint8_t number, syscall_function function,
+			      void *data = NULL);
+	void install_default_syscalls();
+
+	/*
+	 * Illegal opcodes. The optional callback is called when the cpu
+	 * stops (ILLEGAL_OPCODE_STOP). Once stopped, execute() does nothing
+	 * until the next reset().
+	 */
+	typedef void (*illegal_opcode_callback)(mc6809 *cpu, uint16_t address,
+		void *data);
+	void set_illegal_opcode_mode(enum illegal_opcode_mode_t mode,
+				     illegal_opcode_callback callback = NULL,
+				     void *data = NULL);
+	inline bool stopped() { return cpu_state == CPU_STOPPED; }
+	inline enum stop_reason_t get_stop_reason() { return stop_reason; }
+
+	/*
+	 * Per pc profiler. Counts instructions executed and cycles consumed
+	 * per guest address, in flat 64k arrays that are only allocated
+	 * when the profiler is enabled for the first time. Disabling keeps
+	 * the data until reset_profiler().
+	 */
+	void enable_profiler(bool enable);
+	void reset_profiler();
+	uint64_t get_profile_instructions(uint16_t address);
+	uint64_t get_profile_cycles(uint16_t address);
+	void profiler_report(FILE *f, int entries);
+
+	/*
+	 * Dynamic instruction mix: executions per (page, opcode), per
+	 * indexed postbyte class (direct and indirect) and per interrupt
+	 * vector. Pages are 1, 2 ($10 prefix) and 3 ($11 prefix).
+	 */
+	void enable_statistics(bool enable);
+	void reset_statistics();
+	uint64_t get_opcode_count(int page, uint8_t opcode);
+	uint64_t get_indexed_count(int postbyte_class, bool indirect);
+	uint64_t get_interrupt_count(enum statistics_interrupt_t vector);
+	void statistics_csv(FILE *f);
+	void statistics_json(FILE *f);
+
+	/*
+	 * Guest symbols, read from a vlink map file (vlink -M)
+	 */
+	bool load_symbols(const char *filename);
+	void clear_symbols();
+	const char *get_symbol(uint16_t address);
+
+	/*
+	 * Call graph profiler. A shadow stack follows calls (jsr, bsr,
+	 * lbsr), interrupt entries (nmi, firq, irq, swi's) and their
+	 * returns. Write the result in callgrind format for KCachegrind,
+	 * or the call edges with their exclusive cycles as csv.
+	 */
+	void enable_callgraph(bool enable);
+	void reset_callgraph();
+	bool write_callgrind(const char *filename);
+	void callgraph_csv(FILE *f);
+
+	/*
+	 * Sampling profiler. Every period cycles on average (randomised
+	 * between 0.5 and 1.5 period to avoid aliasing with guest loops)
+	 * the pc and return addresses found on the s stack are recorded.
+	 * Output is in folded stack format for flamegraph.pl.
+	 */
+	void enable_sampler(bool enable, uint32_t period = 100);
+	void reset_sampler();
+	bool write_folded_stacks(const char *filename);
+
+	/*
+	 * Binary execution trace in a ring of records (rounded up to a
+	 * power of two), only the most recent ones are kept. save_trace()
+	 * writes them oldest first, decode with the mc6809_trace tool.
+	 */
+	void enable_trace(bool enable, uint32_t records = 1 << 20);
+	void reset_trace();
+	uint64_t get_trace_records();
+	bool save_trace(const char *filename);
+
+	/*
+	 * Streaming trace, same format as save_trace(), for captures that
+	 * don't fit in memory. The file is mmap'd and grown in chunks by a
+	 * background thread, the cpu only stores records into mapped
+	 * memory. Stopping completes the file.
+	 */
+	bool start_trace_stream(const char *filename,
+				uint32_t chunk_records = 1 << 22);
+	bool stop_trace_stream();
+	uint64_t get_trace_stream_records();
+
+	/*
+	 * Code coverage. Bitmaps of executed instructions and of taken and
+	 * not taken conditional branches (bhi ... ble, lbhi ... lble).
+	 * Saved bitmaps from parallel runs can be merged (or'ed). Listing
+	 * and summary disassemble the range start - end linearly.
+	 */
+	void enable_coverage(bool enable);
+	void reset_coverage();
+	bool save_coverage(const char *filename);
+	bool merge_coverage(const char *filename);
+	void coverage_listing(FILE *f, uint16_t start, uint16_t end);
+	void coverage_summary(FILE *f, uint16_t start, uint16_t end);
+
+	/*
+	 * AFL style edge coverage. After every control flow instruction
+	 * (and interrupt entry) map[prev ^ pc]++ with prev = pc >> 1. The
+	 * map (EDGE_MAP_SIZE bytes) can be supplied by the host, e.g. a
+	 * libFuzzer extra counters section, or is allocated.
+	 */
+	void enable_edge_coverage(bool enable, uint8_t *map = NULL);
+	void reset_edge_coverage();
+	uint8_t *get_edge_map() { return edge_map; }
+
+	/*
+	 * Fast state save/restore, no messages, no reset vector fetch
+	 */
+	void save_snapshot(struct mc6809_snapshot *snapshot);
+	void restore_snapshot(const struct mc6809_snapshot *snapshot);
+
+	/*
+	 * Memory heatmap. Counts reads, writes and instruction fetches per
+	 * address (pages are the sum of their bytes) and bus accesses per
+	 * opcode. Reads and writes use the watch page slow path, so all
+	 * pages are flagged while the heatmap is on. type is one or more
+	 * HEAT_* flags or'ed. Maps are 256x256, one row per page.
+	 */
+	void enable_heatmap(bool enable);
+	void reset_heatmap();
+	uint64_t get_heat(uint16_t address, uint8_t type);
+	uint64_t get_page_heat(uint8_t page, uint8_t type);
+	void heatmap_pgm(FILE *f, uint8_t type);
+	void heatmap_csv(FILE *f, uint8_t type);
+	void bus_statistics_csv(FILE *f);
+
+	/*
+	 * Interrupt latency, per source (STAT_NMI, STAT_FIRQ, STAT_IRQ):
+	 * cycles from the line being seen asserted (checked before every
+	 * instruction) until the interrupt is taken, and service time from
+	 * entry to the rti that returns from it. Periods with the i or f
+	 * flag set are attributed to the pc's that set and cleared them.
+	 */
+	void enable_interrupt_latency(bool enable);
+	void reset_interrupt_latency();
+	const struct mc6809_latency_stats &get_interrupt_latency(enum statistics_interrupt_t source);
+	const struct mc6809_latency_stats &get_interrupt_service(enum statistics_interrupt_t source);
+	void interrupt_latency_report(FILE *f, int masked_entries);
+
 private:
 	uint16_t pc;	// program counter
 	uint8_t	 dp;	// direct page register
@@ -213,8 +687,28 @@ private:
 	uint8_t  cc;	// condition code register
 
 	enum cpu_state_t cpu_state;
+	enum stop_reason_t stop_reason;
 
-	uint16_t *index_regs[4];
+	/*
+	 * Address of the first byte (opcode) of the current instruction
+	 */
+	uint16_t instruction_pc;
+
+	/*
+	 * Current opcode, for page 2 and 3 the byte after the prefix
+	 */
+	uint8_t opcode;
+
+	/*
+	 * Instruction bytes consumed by fetch8() in the current step, the
+	 * instruments use these instead of reading memory again.
+	 */
+	uint8_t fetched[8];
+	uint8_t fetched_bytes;
+
+	enum illegal_opcode_mode_t illegal_opcode_mode;
+	illegal_opcode_callback illegal_callback;
+	void *illegal_callback_data;
 
 	bool nmi_enabled;
 	bool default_pin;
@@ -229,8 +723,251 @@ private:
 	int32_t cycle_saldo;
 	uint32_t cycles;
 
+	uint8_t *breakpoint_bits;
+	uint32_t breakpoints_armed;
+	bool breakpoint_reached;	// condition met at breakpoint_pc
+	uint16_t breakpoint_pc;
+
+	struct breakpoint_condition {
+		uint16_t address;
+		uint32_t hits;
+		std::vector<uint32_t> code;	// opcode << 16 | operand
+		char text[64];
+	};
+	std::vector<struct breakpoint_condition> breakpoint_conditions;
+	bool check_breakpoint_condition();
+	bool breakpoint_condition_met();
+	void remove_breakpoint_condition(uint16_t address);
+
+	struct watchpoint {
+		uint16_t start;
+		uint16_t end;
+		uint8_t type;
+	};
+	std::vector<struct watchpoint> watchpoints;
+	uint8_t watch_pages[256];	// or'ed watch types per page
+	bool watchpoint_triggered;
+	struct watchpoint_hit watch_hit;
+	void update_watch_pages();
+	void check_watchpoints(uint16_t address, uint8_t value, uint8_t type);	// also counts heat
+
+	/*
+	 * HLE hooks, the bitmap (one bit per address) is only allocated
+	 * when the first hook is registered. As long as hle_hooks is empty,
+	 * execute() pays nothing more than one test.
+	 */
+	struct hle_hook {
+		uint16_t address;
+		hle_function function;
+		void *data;
+		uint16_t cycles;
+	};
+	std::vector<struct hle_hook> hle_hooks;
+	uint8_t *hle_bitmap;
+	inline bool hle_hooked(uint16_t address) {
+		return hle_bitmap[address >> 3] & (1 << (address & 0b111));
+	}
+	bool run_hle_hook();
+
+	/*
+	 * Syscall table, indexed by the immediate byte
+	 */
+	enum syscall_gate_t syscall_gate;
+	struct syscall {
+		syscall_function function;
+		void *data;
+	} syscalls[256];
+	void do_syscall(uint8_t number);
+	FILE *syscall_files[SYSCALL_MAX_FILES];
+	static uint16_t sys_memfill(mc6809 *cpu, struct mc6809_registers *regs, void *data);
+	static uint16_t sys_memcpy(mc6809 *cpu, struct mc6809_registers *regs, void *data);
+	static uint16_t sys_cycles(mc6809 *cpu, struct mc6809_registers *regs, void *data);
+	static uint16_t sys_host_time(mc6809 *cpu, struct mc6809_registers *regs, void *data);
+	static uint16_t sys_open(mc6809 *cpu, struct mc6809_registers *regs, void *data);
+	static uint16_t sys_close(mc6809 *cpu, struct mc6809_registers *regs, void *data);
+	static uint16_t sys_read(mc6809 *cpu, struct mc6809_registers *regs, void *data);
+	static uint16_t sys_write(mc6809 *cpu, struct mc6809_registers *regs, void *data);
+
+	/*
+	 * Enabled instruments (INSTRUMENT_* flags)
+	 */
+	uint32_t instruments;
+	template <bool instrumented> MC6809_INLINE uint16_t step();
+
+	uint64_t *profile_instructions;
+	uint64_t *profile_cycles;
+	inline void profile_instruction(uint16_t consumed) {
+		profile_instructions[instruction_pc]++;
+		profile_cycles[instruction_pc] += consumed;
+	}
+
+	uint64_t opcode_counts[3][256];
+	uint64_t indexed_counts[2][STAT_IDX_CLASSES];
+	uint64_t interrupt_counts[STAT_INTERRUPTS];
+	void count_instruction();
+
+	struct symbol {
+		uint16_t address;
+		char name[48];
+	};
+	std::vector<struct symbol> symbols;
+	void function_name(char *buffer, size_t n, uint32_t function);
+	void location_name(char *buffer, size_t n, uint16_t address);
+
+	/*
+	 * Functions are identified by their entry address. Self cycles of
+	 * an instruction go to callgraph_self_cycles for the first function
+	 * seeing it (callgraph_owner), those of other functions executing
+	 * the same code to callgraph_shared_cycles, keyed by function << 16
+	 * | address.
+	 */
+	struct callgraph_frame {
+		uint32_t function;
+		uint32_t caller;
+		uint16_t call_site;
+		uint16_t sp;		// sp right after the call
+		uint64_t entry_cycles;
+		uint64_t callee_cycles;	// inclusive cycles of returned callees
+	};
+	struct callgraph_edge {
+		uint64_t calls;
+		uint64_t inclusive_cycles;
+		uint64_t exclusive_cycles;	// without the callees
+	};
+	std::vector<struct callgraph_frame> callgraph_stack;
+	std::map<uint64_t, struct callgraph_edge> callgraph_edges;
+	uint64_t callgraph_cycles;
+	uint64_t *callgraph_self_cycles;
+	uint32_t *callgraph_owner;
+	std::map<uint64_t, uint64_t> callgraph_shared_cycles;
+	void callgraph_step(uint16_t consumed, uint16_t old_sp, bool interrupted);
+	void callgraph_return(struct callgraph_frame &frame);
+
+	/*
+	 * The sampler runs in both instantiations of execute(). Its
+	 * countdown stays at INT32_MAX while it's off (period 0).
+	 */
+	uint32_t sampler_period;
+	int32_t sampler_countdown;
+	uint32_t sampler_random;
+	/*
+	 * Open addressing hash table, allocated when the sampler is
+	 * enabled for the first time. An empty slot has count 0.
+	 */
+	struct sampler_stack {
+		uint64_t count;
+		uint16_t frames[SAMPLER_MAX_DEPTH + 1];	// outermost first, pc last
+		uint8_t depth;
+	};
+	struct sampler_stack *samples;
+	uint32_t sampler_stacks;
+	uint64_t samples_dropped;
+	inline void sampler_step(uint16_t consumed) {
+		sampler_countdown -= consumed;
+		if (sampler_countdown <= 0) take_sample();
+	}
+	void take_sample();
+	bool return_address(uint16_t address);
+
+	struct mc6809_trace_record *trace_buffer;
+	uint32_t trace_mask;
+	uint64_t trace_head;
+	uint64_t trace_cycles;
+	inline void trace_record(struct mc6809_trace_record *r,
+				 uint16_t consumed, uint8_t type) {
+		r->pc = instruction_pc;
+		r->xr = xr;
+		r->yr = yr;
+		r->us = us;
+		r->sp = sp;
+		for (int i=0; i<5; i++) r->bytes[i] = i < fetched_bytes ? fetched[i] : 0;
+		r->type = type;
+		r->ac = ac;
+		r->br = br;
+		r->dp = dp;
+		r->cc = cc;
+		r->cycles = consumed;
+	}
+	inline void trace_step(uint16_t consumed, uint8_t type) {
+		trace_record(&trace_buffer[trace_head++ & trace_mask], consumed, type);
+		trace_cycles += consumed;
+	}
+
+	/*
+	 * Records go to stream_next until stream_end, then the next chunk
+	 * prepared by the background thread is taken.
+	 */
+	trace_stream *stream;
+	struct mc6809_trace_record *stream_next;
+	struct mc6809_trace_record *stream_end;
+	inline void trace_stream_step(uint16_t consumed, uint8_t type) {
+		if (stream_next == stream_end) next_stream_chunk();
+		trace_record(stream_next++, consumed, type);
+	}
+	void next_stream_chunk();
+
+	/*
+	 * Bitmaps of 8kb each. Once an instruction needs no further
+	 * recording (executed, and both ways if it's a branch) its done
+	 * bit is set and it only costs a bit test.
+	 */
+	uint8_t *coverage_executed;
+	uint8_t *coverage_taken;
+	uint8_t *coverage_not_taken;
+	uint8_t *coverage_done;
+	inline void coverage_step() {
+		if (!(coverage_done[instruction_pc >> 3] & (1 << (instruction_pc & 0b111))))
+			coverage_instruction();
+	}
+	void coverage_instruction();
+
+	uint8_t *edge_map;
+	bool edge_map_owned;
+	uint16_t edge_previous;
+	inline void edge_step() {
+		edge_map[edge_previous ^ pc]++;
+		edge_previous = pc >> 1;
+	}
+
+	uint64_t *heat_reads;
+	uint64_t *heat_writes;
+	uint64_t *heat_fetches;
+	struct bus_counts {
+		uint64_t executions;
+		uint64_t fetches;
+		uint64_t reads;
+		uint64_t writes;
+	} bus_counts[4][256];	// pages 1-3, interrupt entries in [3][0]
+	uint32_t step_reads;
+	uint32_t step_writes;
+	void heatmap_step(bool interrupted);
+
+	uint64_t latency_cycles;
+	uint64_t line_asserted[STAT_SWI];	// cycle seen asserted
+	bool line_pending[STAT_SWI];
+	struct mc6809_latency_stats latency[STAT_SWI];
+	struct mc6809_latency_stats service[STAT_SWI];
+	struct service_frame {
+		enum statistics_interrupt_t source;
+		uint16_t sp;
+		uint64_t entry;
+	};
+	std::vector<struct service_frame> service_stack;
+	struct masked_period {
+		uint64_t count;
+		uint64_t total;
+		uint64_t max;
+	};
+	std::map<uint64_t, struct masked_period> masked_periods;	// flag << 32 | from << 16 | to
+	uint16_t mask_start_pc[2];	// i, f
+	uint64_t mask_start[2];
+	void latency_lines();
+	void latency_step(uint16_t consumed, uint8_t old_cc,
+			  enum statistics_interrupt_t interrupt);
+
 	typedef uint16_t (mc6809::*addressing_mode)(bool *legal);
 	typedef void (mc6809::*execute_instruction)(uint16_t);
+	typedef void (mc6809::*opcode_handler)();
 
 	bool disassemble_success;
 
@@ -239,18 +976,87 @@ private:
 	 * by the execute() function that polls the different interrupt lines
 	 * or detects an illegal opcode.
 	 */
-	void nmi();
-	void firq();
-	void irq();
+	MC6809_INLINE void nmi();
+	MC6809_INLINE void firq();
+	MC6809_INLINE void irq();
 	void illegal_opcode();
 
+	/*
+	 * Memory access by the cpu itself goes through these functions.
+	 * Instruction stream (pc) reads use fetch8(), all other reads and
+	 * writes use bus_read8() and bus_write8(). Only pages with a flag
+	 * set in watch_pages take the slow path.
+	 */
+	inline uint8_t fetch8() {
+		uint8_t value = read8(pc++);
+		fetched[fetched_bytes++ & 0b111] = value;
+		return value;
+	}
+	inline uint8_t bus_read8(uint16_t address) {
+		uint8_t value = read8(address);
+		if (watch_pages[address >> 8] & WATCH_READ) {
+			check_watchpoints(address, value, WATCH_READ);
+		}
+		return value;
+	}
+	inline void bus_write8(uint16_t address, uint8_t value) {
+		if (watch_pages[address >> 8] & WATCH_WRITE) {
+			check_watchpoints(address, value, WATCH_WRITE);
+		}
+		write8(address, value);
+	}
+
 	/*
 	 * Internal stackpointer functionality
 	 */
-	inline void    push_sp(uint8_t byte) { write8(--sp, byte); }
-	inline uint8_t pull_sp()             { return read8(sp++); }
-	inline void    push_us(uint8_t byte) { write8(--us, byte); }
-	inline uint8_t pull_us()             { return read8(us++); }
+	inline void    push_sp(uint8_t byte) { bus_write8(--sp, byte); }
+	inline uint8_t pull_sp()             { return bus_read8(sp++); }
+	inline void    push_us(uint8_t byte) { bus_write8(--us, byte); }
+	inline uint8_t pull_us()             { return bus_read8(us++); }
+
+	/*
+	 * Arithmetic with its flags, shared by the instruction handlers
+	 * and the fused handlers. sub8 and sub16 are also the compares.
+	 */
+	inline uint8_t add8(uint8_t a, uint8_t b, uint8_t carry) {
+		/*
+		 * See: Osborne, A. 1976. An introduction to microcomputers
+		 * Volume I Basic Concepts. SYBEX. pages 4-12 to 4-16.
+		 */
+		if (((a & 0x0f) + (b & 0x0f) + carry) & 0b00010000) set_h_flag(); else clear_h_flag();
+		bool bit_7_carry_in = (((a & 0x7f) + (b & 0x7f) + carry) & 0x80) ? true : false;
+		uint16_t result = a + b + carry;
+		bool carry_out = (result & 0x0100) ? true : false;
+		if (carry_out != bit_7_carry_in) set_v_flag(); else clear_v_flag();
+		if (carry_out) set_c_flag(); else clear_c_flag();
+		test_nz_flags(result & 0xff);
+		return result & 0xff;
+	}
+	inline uint8_t sub8(uint8_t a, uint8_t b, uint8_t carry) {
+		/* code inspired by virtualc64 */
+		uint16_t result = a - b - carry;
+		if (result > 255) set_c_flag(); else clear_c_flag();
+		if (((a ^ result) & 0x80) && ((a ^ b) & 0x80)) set_v_flag(); else clear_v_flag();
+		test_nz_flags(result & 0xff);
+		return result & 0xff;
+	}
+	inline uint16_t add16(uint16_t a, uint16_t b) {
+		/* no need for half-carry here */
+		bool bit_15_carry_in = (((a & 0x7fff) + (b & 0x7fff)) & 0x8000) ? true : false;
+		uint32_t result = a + b;
+		bool carry_out = (result & 0x00010000) ? true : false;
+		if (carry_out != bit_15_carry_in) set_v_flag(); else clear_v_flag();
+		if (carry_out) set_c_flag(); else clear_c_flag();
+		test_nz_flags_16(result & 0xffff);
+		return result & 0xffff;
+	}
+	inline uint16_t sub16(uint16_t a, uint16_t b) {
+		uint32_t result = a - b;
+		if (result > 65535) set_c_flag(); else clear_c_flag();
+		if (((a ^ result) & 0x8000) && ((a ^ b) & 0x8000)) set_v_flag(); else clear_v_flag();
+		test_nz_flags_16(result & 0xffff);
+		return result & 0xffff;
+	}
 
 	/*
 	 * addressing modes
@@ -282,28 +1088,12 @@ private:
 	void asr(uint16_t ea);
 	void asra(uint16_t ea);
 	void asrb(uint16_t ea);
-	void beq(uint16_t ea);
 
-	void bge(uint16_t ea);
-	void bgt(uint16_t ea);
-	void bhi(uint16_t ea);
-	void bhs(uint16_t ea);		// bcc
 	void bita(uint16_t ea);
 	void bitb(uint16_t ea);
-	void bmi(uint16_t ea);
-	void ble(uint16_t ea);
-
-	void blo(uint16_t ea);		// bcs
-	void bls(uint16_t ea);
-	void blt(uint16_t ea);
-	void bne(uint16_t ea);
-	void bpl(uint16_t ea);
-	void bra(uint16_t ea);
-	void brn(uint16_t ea);
+	void branch(uint16_t ea);	// bra to ble
 	void bsr(uint16_t ea);
 
-	void bvc(uint16_t ea);
-	void bvs(uint16_t ea);
 	void clr(uint16_t ea);
 	void clra(uint16_t ea);
 	void clrb(uint16_t ea);
@@ -334,25 +1124,8 @@ private:
 	void incb(uint16_t ea);
 	void jmp(uint16_t ea);
 	void jsr(uint16_t ea);
-	void lbeq(uint16_t ea);
-	void lbge(uint16_t ea);
-	void lbgt(uint16_t ea);
-
-	void lbhi(uint16_t ea);
-	void lbhs(uint16_t ea);		// lbcc
-	void lble(uint16_t ea);
-	void lblo(uint16_t ea);		// lbcs
-	void lbls(uint16_t ea);
-	void lblt(uint16_t ea);
-	void lbmi(uint16_t ea);
-	void lbne(uint16_t ea);
-
-	void lbpl(uint16_t ea);
 	void lbra(uint16_t ea);
-	void lbrn(uint16_t ea);
 	void lbsr(uint16_t ea);
-	void lbvc(uint16_t ea);
-	void lbvs(uint16_t ea);
 	void lda(uint16_t ea);
 	void ldb(uint16_t ea);
 
@@ -366,6 +1139,7 @@ private:
 	void leax(uint16_t ea);
 
 	void leay(uint16_t ea);
+	void long_branch(uint16_t ea);	// lbrn to lble
 	void lsr(uint16_t ea);
 	void lsra(uint16_t ea);
 	void lsrb(uint16_t ea);
@@ -415,278 +1189,179 @@ private:
 	void swi3(uint16_t ea);
 
 	void sync(uint16_t ea);
+	void sys(uint16_t ea);		// syscall gate (not a real 6809 instruction)
 	void tfr(uint16_t ea);
 	void tst(uint16_t ea);
 	void tsta(uint16_t ea);
 	void tstb(uint16_t ea);
 
 private:
-	const execute_instruction opcodes_page1[256] = {
-		&mc6809::neg,	&mc6809::ill,	&mc6809::ill,	&mc6809::com,	&mc6809::lsr,	&mc6809::ill,	&mc6809::ror,	&mc6809::asr,	// 0x00
-		&mc6809::asl,	&mc6809::rol,	&mc6809::dec,	&mc6809::ill,	&mc6809::inc,	&mc6809::tst,	&mc6809::jmp,	&mc6809::clr,
-		&mc6809::page2,	&mc6809::page3,	&mc6809::nop,	&mc6809::sync,	&mc6809::ill,	&mc6809::ill,	&mc6809::lbra,	&mc6809::lbsr,	// 0x10
-		&mc6809::ill,	&mc6809::daa,	&mc6809::orcc,	&mc6809::ill,	&mc6809::andcc,	&mc6809::sex,	&mc6809::exg,	&mc6809::tfr,
-		&mc6809::bra,	&mc6809::brn,	&mc6809::bhi,	&mc6809::bls,	&mc6809::bhs,	&mc6809::blo,	&mc6809::bne,	&mc6809::beq,	// 0x20
-		&mc6809::bvc,	&mc6809::bvs,	&mc6809::bpl,	&mc6809::bmi,	&mc6809::bge,	&mc6809::blt,	&mc6809::bgt,	&mc6809::ble,
-		&mc6809::leax,	&mc6809::leay,	&mc6809::leas,	&mc6809::leau,	&mc6809::pshs,	&mc6809::puls,	&mc6809::pshu,	&mc6809::pulu,	// 0x30
-		&mc6809::ill,	&mc6809::rts,	&mc6809::abx,	&mc6809::rti,	&mc6809::cwai,	&mc6809::mul,	&mc6809::ill,	&mc6809::swi,
-		&mc6809::nega,	&mc6809::ill,	&mc6809::ill,	&mc6809::coma,	&mc6809::lsra,	&mc6809::ill,	&mc6809::rora,	&mc6809::asra,	// 0x40
-		&mc6809::asla,	&mc6809::rola,	&mc6809::deca,	&mc6809::ill,	&mc6809::inca,	&mc6809::tsta,	&mc6809::ill,	&mc6809::clra,
-		&mc6809::negb,	&mc6809::ill,	&mc6809::ill,	&mc6809::comb,	&mc6809::lsrb,	&mc6809::ill,	&mc6809::rorb,	&mc6809::asrb,	// 0x50
-		&mc6809::aslb,	&mc6809::rolb,	&mc6809::decb,	&mc6809::ill,	&mc6809::incb,	&mc6809::tstb,	&mc6809::ill,	&mc6809::clrb,
-		&mc6809::neg,	&mc6809::ill,	&mc6809::ill,	&mc6809::com,	&mc6809::lsr,	&mc6809::ill,	&mc6809::ror,	&mc6809::asr,	// 0x60
-		&mc6809::asl,	&mc6809::rol,	&mc6809::dec,	&mc6809::ill,	&mc6809::inc,	&mc6809::tst,	&mc6809::jmp,	&mc6809::clr,
-		&mc6809::neg,	&mc6809::ill,	&mc6809::ill,	&mc6809::com,	&mc6809::lsr,	&mc6809::ill,	&mc6809::ror,	&mc6809::asr,	// 0x70
-		&mc6809::asl,	&mc6809::rol,	&mc6809::dec,	&mc6809::ill,	&mc6809::inc,	&mc6809::tst,	&mc6809::jmp,	&mc6809::clr,
-		&mc6809::suba,	&mc6809::cmpa,	&mc6809::sbca,	&mc6809::subd,	&mc6809::anda,	&mc6809::bita,	&mc6809::lda,	&mc6809::ill,	// 0x80
-		&mc6809::eora,	&mc6809::adca,	&mc6809::ora,	&mc6809::adda,	&mc6809::cmpx,	&mc6809::bsr,	&mc6809::ldx,	&mc6809::ill,
-		&mc6809::suba,	&mc6809::cmpa,	&mc6809::sbca,	&mc6809::subd,	&mc6809::anda,	&mc6809::bita,	&mc6809::lda,	&mc6809::sta,	// 0x90
-		&mc6809::eora,	&mc6809::adca,	&mc6809::ora,	&mc6809::adda,	&mc6809::cmpx,	&mc6809::jsr,	&mc6809::ldx,	&mc6809::stx,
-		&mc6809::suba,	&mc6809::cmpa,	&mc6809::sbca,	&mc6809::subd,	&mc6809::anda,	&mc6809::bita,	&mc6809::lda,	&mc6809::sta,	// 0xa0
-		&mc6809::eora,	&mc6809::adca,	&mc6809::ora,	&mc6809::adda,	&mc6809::cmpx,	&mc6809::jsr,	&mc6809::ldx,	&mc6809::stx,
-		&mc6809::suba,	&mc6809::cmpa,	&mc6809::sbca,	&mc6809::subd,	&mc6809::anda,	&mc6809::bita,	&mc6809::lda,	&mc6809::sta,	// 0xb0
-		&mc6809::eora,	&mc6809::adca,	&mc6809::ora,	&mc6809::adda,	&mc6809::cmpx,	&mc6809::jsr,	&mc6809::ldx,	&mc6809::stx,
-		&mc6809::subb,	&mc6809::cmpb,	&mc6809::sbcb,	&mc6809::addd,	&mc6809::andb,	&mc6809::bitb,	&mc6809::ldb,	&mc6809::ill,	// 0xc0
-		&mc6809::eorb,	&mc6809::adcb,	&mc6809::orb,	&mc6809::addb,	&mc6809::ldd,	&mc6809::ill,	&mc6809::ldu,	&mc6809::ill,
-		&mc6809::subb,	&mc6809::cmpb,	&mc6809::sbcb,	&mc6809::addd,	&mc6809::andb,	&mc6809::bitb,	&mc6809::ldb,	&mc6809::stb,	// 0xd0
-		&mc6809::eorb,	&mc6809::adcb,	&mc6809::orb,	&mc6809::addb,	&mc6809::ldd,	&mc6809::std,	&mc6809::ldu,	&mc6809::stu,
-		&mc6809::subb,	&mc6809::cmpb,	&mc6809::sbcb,	&mc6809::addd,	&mc6809::andb,	&mc6809::bitb,	&mc6809::ldb,	&mc6809::stb,	// 0xe0
-		&mc6809::eorb,	&mc6809::adcb,	&mc6809::orb,	&mc6809::addb,	&mc6809::ldd,	&mc6809::std,	&mc6809::ldu,	&mc6809::stu,
-		&mc6809::subb,	&mc6809::cmpb,	&mc6809::sbcb,	&mc6809::addd,	&mc6809::andb,	&mc6809::bitb,	&mc6809::ldb,	&mc6809::stb,	// 0xf0
-		&mc6809::eorb,	&mc6809::adcb,	&mc6809::orb,	&mc6809::addb,	&mc6809::ldd,	&mc6809::std,	&mc6809::ldu,	&mc6809::stu
+	/*
+	 * Operand modes, as used by the disassembler. Every mode maps to one
+	 * of the addressing mode functions (see mc6809_opcodes.cpp).
+	 */
+	enum addr_mode_index {
+		__DIR_,	// direct
+		__NOM_,	// no mode
+		__REB_,	// relative byte
+		__REW_,	// relative word
+		__IMB_,	// immediate byte
+		__IMW_,	// immediate word
+		__IBB_,	// immediate byte binary (for andcc and orcc)
+		__EXT_,	// extended
+		__INH_,	// inherent
+		__R1_,	// tfr/exg mode
+		__R2_,	// pul/psh system
+		__R3_,	// pul/psh user
+		__IDX_,	// indexed
+
+
+		// __BD_,	// Bit Manipulation direct	// 6309??
+		// __BI_,	// Bit Manipulation index	// 6309??
+		// __BE_,	// Bit Manipulation extended	// 6309??
+		// __BT_,	// Bit Transfers direct		// 6309??
+		// __T1_,	// Block Transfer r0+,r1+	// 6309??
+		// __T2_,	// Block Transfer r0-,r1-	// 6309??
+		// __T3_,	// Block Transfer r0+,r1	// 6309??
+		// __T4_,	// Block Transfer r0,r1+	// 6309??
+		// __IML_ 	// immediate 32-bit		// 6309??
 	};
 
-	const execute_instruction opcodes_page2[256] = {
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x00
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x10
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::lbrn,	&mc6809::lbhi,	&mc6809::lbls,	&mc6809::lbhs,	&mc6809::lblo,	&mc6809::lbne,	&mc6809::lbeq,	// 0x20
-		&mc6809::lbvc,	&mc6809::lbvs,	&mc6809::lbpl,	&mc6809::lbmi,	&mc6809::lbge,	&mc6809::lblt,	&mc6809::lbgt,	&mc6809::lble,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x30
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::swi2,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x40
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x50
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x60
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x70
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpd,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x80
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpy,	&mc6809::ill,	&mc6809::ldy,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpd,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x90
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpy,	&mc6809::ill,	&mc6809::ldy,	&mc6809::sty,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpd,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xa0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpy,	&mc6809::ill,	&mc6809::ldy,	&mc6809::sty,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpd,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xb0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpy,	&mc6809::ill,	&mc6809::ldy,	&mc6809::sty,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xc0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::lds,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xd0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::lds,	&mc6809::sts,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xe0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::lds,	&mc6809::sts,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xf0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::lds,	&mc6809::sts
+	/*
+	 * One entry per legal opcode, the single source for the executor,
+	 * cycle and disassembler tables. Page 0 is unprefixed, 1 is $10 and
+	 * 2 is $11. flags holds the cc bits the instruction may change.
+	 * Without a fused handler, the opcode runs the addressing mode
+	 * function of its mode and then handler.
+	 */
+	struct opcode_spec {
+		uint8_t page;
+		uint8_t opcode;
+		const char *mnemonic;	// padded with spaces to five characters
+		enum addr_mode_index mode;
+		uint16_t cycles;
+		execute_instruction handler;
+		uint8_t flags;
+		opcode_handler fused = nullptr;
 	};
 
-	const execute_instruction opcodes_page3[256] = {
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x00
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x10
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x20
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x30
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::swi3,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x40
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x50
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x60
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x70
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpu,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x80
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmps,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpu,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x90
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmps,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpu,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xa0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmps,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpu,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xb0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmps,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xc0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xd0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xe0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xf0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill
-	};
+	static const struct opcode_spec opcode_specs[];
+	static const addressing_mode mode_functions[];
 
-	const addressing_mode addressing_modes_page1[256] = {
-		&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_dir,	// 0x00
-		&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,
-		&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_rew,	&mc6809::a_rew,	// 0x10
-		&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_imb,	&mc6809::a_no,	&mc6809::a_imb,	&mc6809::a_ih,	&mc6809::a_imb,	&mc6809::a_imb,
-		&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	// 0x20
-		&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	// 0x30
-		&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,
-		&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	// 0x40
-		&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,
-		&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	// 0x50
-		&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,
-		&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_idx,	// 0x60
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,
-		&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_ext,	// 0x70
-		&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,
-		&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imw,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_no,	// 0x80
-		&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imw,	&mc6809::a_reb,	&mc6809::a_imw,	&mc6809::a_no,
-		&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	// 0x90
-		&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	// 0xa0
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,
-		&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	// 0xb0
-		&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,
-		&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imw,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_no,	// 0xc0
-		&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imw,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,
-		&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	// 0xd0
-		&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	// 0xe0
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,
-		&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	// 0xf0
-		&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext
+	/*
+	 * Generated from opcode_specs at compile time. execute holds one
+	 * handler per opcode, either the fused one or execute_spec<>() for
+	 * the entry. Opcodes without an entry are illegal: ill(), 0 cycles
+	 * and "???".
+	 */
+	struct opcode_tables {
+		opcode_handler execute[3][256];
+		uint16_t cycles[3][256];
+		const char *mnemonics[3][256];
+		enum addr_mode_index operands[3][256];
+		uint8_t flags[3][256];
 	};
 
-	const addressing_mode addressing_modes_page2[256] = {
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x00
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x10
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	// 0x20
-		&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x30
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ih,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x40
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x50
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x60
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x70
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x80
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x90
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_dir,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xa0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_idx,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xb0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_ext,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xc0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xd0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_dir,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xe0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_idx,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xf0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_ext
+	template <size_t... spec>
+	static constexpr struct opcode_tables generate_opcode_tables(std::index_sequence<spec...>);
+	static const struct opcode_tables opcode_table;
+
+	template <size_t spec> void execute_spec();
+	void execute_illegal();
+
+	/*
+	 * Indexed postbyte descriptors, one per postbyte, generated at
+	 * compile time and used by a_idx(). reg is the base register (pc
+	 * for the pc relative modes). constant is the 5 bit offset, or the
+	 * step of ,r+ ,r++ ,-r and ,--r. cycles are on top of the opcode's
+	 * cycles.
+	 */
+	enum index_offset {
+		IDX_CONSTANT,	// no offset or 5 bit offset
+		IDX_INCREMENT,	// ,r+ ,r++
+		IDX_DECREMENT,	// ,-r ,--r
+		IDX_8BIT,
+		IDX_16BIT,
+		IDX_A,
+		IDX_B,
+		IDX_D,
+		IDX_EXTENDED,	// [n16]
+		IDX_ILLEGAL
 	};
 
-	const addressing_mode addressing_modes_page3[256] = {
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x00
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x10
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x20
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x30
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ih,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x40
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x50
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x60
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x70
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x80
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x90
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xa0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xb0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xc0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xd0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xe0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xf0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no
+	struct index_postbyte {
+		uint16_t mc6809::*reg;
+		enum index_offset offset;
+		int8_t constant;
+		bool indirect;
+		uint8_t cycles;
 	};
 
-	const uint16_t cycles_page1[256] = {
-		 6,  0,  0,  6,  6,  0,  6,  6,  6,  6,  6,  0,  6,  6,  3,  6,	// 0x00
-		 0,  0,  2,  4,  0,  0,  5,  9,  0,  2,  3,  0,  3,  2,  8,  6,	// 0x10
-		 3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,	// 0x20
-		 4,  4,  4,  4,  5,  5,  5,  5,  0,  5,  3,  6, 20, 11,  0, 19,	// 0x30
-		 2,  0,  0,  2,  2,  0,  2,  2,  2,  2,  2,  0,  2,  2,  0,  2,	// 0x40
-		 2,  0,  0,  2,  2,  0,  2,  2,  2,  2,  2,  0,  2,  2,  0,  2,	// 0x50
-		 6,  0,  0,  6,  6,  0,  6,  6,  6,  6,  6,  0,  6,  6,  3,  6,	// 0x60
-		 7,  0,  0,  7,  7,  0,  7,  7,  7,  7,  7,  0,  7,  7,  4,  7,	// 0x70
-		 2,  2,  2,  4,  2,  2,  2,  0,  2,  2,  2,  2,  4,  7,  3,  0,	// 0x80
-		 4,  4,  4,  6,  4,  4,  4,  4,  4,  4,  4,  4,  6,  7,  5,  5,	// 0x90
-		 4,  4,  4,  6,  4,  4,  4,  4,  4,  4,  4,  4,  6,  7,  5,  5,	// 0xa0
-		 5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  5,  7,  8,  6,  6,	// 0xb0
-		 2,  2,  2,  4,  2,  2,  2,  0,  2,  2,  2,  2,  3,  0,  3,  0,	// 0xc0
-		 4,  4,  4,  6,  4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,	// 0xd0
-		 4,  4,  4,  6,  4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,	// 0xe0
-		 5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  5,  6,  6,  6,  6	// 0xf0
+	struct index_postbytes {
+		struct index_postbyte postbyte[256];
 	};
 
-	const uint16_t cycles_page2[256] = {
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x00
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x10
-		 0,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,	// 0x20
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 20,	// 0x30
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x40
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x50
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x60
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x70
-		 0,  0,  0,  5,  0,  0,  0,  0,  0,  0,  0,  0,  5,  0,  4,  0,	// 0x80
-		 0,  0,  0,  7,  0,  0,  0,  0,  0,  0,  0,  0,  7,  0,  6,  6,	// 0x90
-		 0,  0,  0,  7,  0,  0,  0,  0,  0,  0,  0,  0,  7,  0,  6,  6,	// 0xa0
-		 0,  0,  0,  8,  0,  0,  0,  0,  0,  0,  0,  0,  8,  0,  7,  7,	// 0xb0
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  4,  0,	// 0xc0
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  6,  6,	// 0xd0
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  6,  6,	// 0xe0
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  7,  7	// 0xf0
+	static constexpr struct index_postbyte decode_postbyte(uint8_t postbyte);
+	static constexpr struct index_postbytes generate_index_postbytes();
+	static const struct index_postbytes index_table;
+
+	/*
+	 * Branch conditions, one entry per cc value. Bit n of an entry is
+	 * set when the condition of branch opcode $2n holds (bit 0 is bra,
+	 * bit 15 is ble). Shared by the short and long branches and the
+	 * branch coverage.
+	 */
+	struct branch_conditions {
+		uint16_t taken[256];
 	};
 
-	const uint16_t cycles_page3[256] = {
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x00
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x10
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x20
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 20,	// 0x30
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x40
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x50
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x60
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0x70
-		 0,  0,  0,  5,  0,  0,  0,  0,  0,  0,  0,  0,  5,  0,  0,  0,	// 0x80
-		 0,  0,  0,  7,  0,  0,  0,  0,  0,  0,  0,  0,  7,  0,  0,  0,	// 0x90
-		 0,  0,  0,  7,  0,  0,  0,  0,  0,  0,  0,  0,  7,  0,  0,  0,	// 0xa0
-		 0,  0,  0,  8,  0,  0,  0,  0,  0,  0,  0,  0,  8,  0,  0,  0,	// 0xb0
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0xc0
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0xd0
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,	// 0xe0
-		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0	// 0xf0
+	static constexpr uint16_t decode_branch_conditions(uint8_t cc);
+	static constexpr struct branch_conditions generate_branch_conditions();
+	static const struct branch_conditions branch_table;
+
+	/*
+	 * Fused handlers, op<LDA, IMM8>() and so on. Operand fetch and
+	 * operation compile into one function, without a call to an
+	 * addressing mode function. Immediate operands are read with
+	 * fetch8(), as part of the instruction stream. SYS is the syscall
+	 * gate sys #imm ($11 $3e).
+	 */
+	enum fused_operation {
+		SUBA, CMPA, SBCA, ANDA, BITA, LDA, STA, EORA, ADCA, ORA, ADDA,
+		SUBB, CMPB, SBCB, ANDB, BITB, LDB, STB, EORB, ADCB, ORB, ADDB,
+		SUBD, ADDD, CMPD, CMPX, CMPY, CMPU, CMPS,
+		LDD, LDX, LDY, LDU, LDS, STD, STX, STY, STU, STS,
+		SYS
 	};
+
+	enum fused_mode { IMM8, IMM16, DIR, EXT };
+
+	template <int operation, int mode> void op();
+	template <int mode> inline uint16_t fused_address();
+	template <int mode> inline uint8_t fused_read8();
+	template <int mode> inline uint16_t fused_read16();
 };
 
+#ifdef MC6809_IMPLEMENTATION
+#include "mc6809.cpp"
+#include "mc6809_debugger.cpp"
+#include "mc6809_disassembler.cpp"
+#include "mc6809_hle.cpp"
+#include "mc6809_profiler.cpp"
+#include "mc6809_statistics.cpp"
+#include "mc6809_callgraph.cpp"
+#include "mc6809_sampler.cpp"
+#include "mc6809_symbols.cpp"
+#include "mc6809_trace.cpp"
+#include "mc6809_trace_stream.cpp"
+#include "mc6809_coverage.cpp"
+#include "mc6809_edges.cpp"
+#include "mc6809_heatmap.cpp"
+#include "mc6809_latency.cpp"
+#include "mc6809_syscalls.cpp"
+#include "mc6809_instructions.cpp"
+#include "mc6809_addressing_modes.cpp"
+#include "mc6809_opcodes.cpp"
+#endif
+
 #endif
@@ -9,7 +9,7 @@
 uint16_t mc6809::a_dir(bool *legal)
 {
 	*legal = true;
-	return (dp << 8) | read8(pc++);
+	return (dp << 8) | fetch8();
 }
 
 uint16_t mc6809::a_ih(bool *legal)
@@ -36,370 +36,212 @@ uint16_t mc6809::a_imw(bool *legal)
 uint16_t mc6809::a_reb(bool *legal)
 {
 	// sign extend the 8 bit value
-	uint16_t offset = (uint16_t)((int8_t)read8(pc++));
+	uint16_t offset = (uint16_t)((int8_t)fetch8());
 	*legal = true;
 	return (uint16_t)(pc + offset);
 }
 
 uint16_t mc6809::a_rew(bool *legal)
 {
-	uint16_t offset = read8(pc++);
-	offset = (offset << 8) | read8(pc++);
+	uint16_t offset = fetch8();
+	offset = (offset << 8) | fetch8();
 	*legal = true;
 	return pc + offset;
 }
 
-uint16_t mc6809::a_idx(bool *legal)
+/*
+ * Descriptor for one indexed postbyte. Cycles for the indirect forms
+ * are those of the non-indirect form plus 3, [n16] takes 5. ,r+ and ,-r
+ * have no indirect form. Illegal postbytes are IDX_ILLEGAL and take no
+ * cycles.
+ */
+constexpr struct mc6809::index_postbyte mc6809::decode_postbyte(uint8_t postbyte)
 {
-	/*
-	 * First, assume the addressing mode is legal. If not, this
-	 * flag will be changed in the code below.
-	 */
-	*legal = true;
-
-	uint16_t address = 0;
-	uint16_t offset;
-	uint8_t byte;
-	uint16_t word;
-
-	// read postbyte
-	uint8_t postbyte = read8(pc++);
-
-	if (postbyte == 0b10011111) {
+	uint16_t mc6809::*index_regs[4] = {
+		&mc6809::xr, &mc6809::yr, &mc6809::us, &mc6809::sp
+	};
+	struct index_postbyte d = {
+		index_regs[(postbyte & 0b01100000) >> 5],
+		IDX_CONSTANT, 0, false, 0
+	};
+
+	if (!(postbyte & 0b10000000)) {
 		/*
-		 * indirect extended
+		 * non-indirect, constant 5-bit signed offset
 		 */
-		cycles += 5;
-
-		word = read8(pc++) << 8;
-		word |= read8(pc++);
-		address = read8(word++) << 8;
-		address |= read8(word);
-	} else {
-		switch (postbyte & 0b10000000) {
-		case 0b00000000:
-			/*
-			 * non-indirect, constant 5-bit signed offset
-			 */
-			cycles += 1;
+		d.constant = (postbyte & 0b00001111) - ((postbyte & 0b00010000) ? 16 : 0);
+		d.cycles = 1;
+		return d;
+	}
 
-			if (postbyte & 0b00010000) {
-				offset = 0xffe0 | (postbyte & 0x1f);
-			} else {
-				offset = postbyte & 0x0f; // bit 4 always 0
-			}
-			address = *index_regs[(postbyte & 0b01100000) >> 5]
-				+ offset;
+	d.indirect = postbyte & 0b00010000;
+
+	switch (postbyte & 0b00001111) {
+	case 0b0000:
+		// auto increment by 1
+		d.offset = IDX_INCREMENT;
+		d.constant = 1;
+		d.cycles = 2;
+		break;
+	case 0b0001:
+		// auto increment by 2
+		d.offset = IDX_INCREMENT;
+		d.constant = 2;
+		d.cycles = 3;
+		break;
+	case 0b0010:
+		// auto decrement by 1
+		d.offset = IDX_DECREMENT;
+		d.constant = 1;
+		d.cycles = 2;
+		break;
+	case 0b0011:
+		// auto decrement by 2
+		d.offset = IDX_DECREMENT;
+		d.constant = 2;
+		d.cycles = 3;
+		break;
+	case 0b0100:
+		// no offset
+		break;
+	case 0b0101:
+		// accumulator b offset
+		d.offset = IDX_B;
+		d.cycles = 1;
+		break;
+	case 0b0110:
+		// accumulator a offset
+		d.offset = IDX_A;
+		d.cycles = 1;
+		break;
+	case 0b1000:
+		// 8-bit offset
+		d.offset = IDX_8BIT;
+		d.cycles = 1;
+		break;
+	case 0b1001:
+		// 16-bit offset
+		d.offset = IDX_16BIT;
+		d.cycles = 4;
+		break;
+	case 0b1011:
+		// accumulator d offset
+		d.offset = IDX_D;
+		d.cycles = 4;
+		break;
+	case 0b1100:
+		// constant offset pc 8bit
+		d.reg = &mc6809::pc;
+		d.offset = IDX_8BIT;
+		d.cycles = 1;
+		break;
+	case 0b1101:
+		// constant offset pc 16bit
+		d.reg = &mc6809::pc;
+		d.offset = IDX_16BIT;
+		d.cycles = 5;
+		break;
+	case 0b1111:
+		// indirect extended, only as $9f
+		if (postbyte == 0b10011111) {
+			d.offset = IDX_EXTENDED;
+			d.cycles = 2;
 			break;
-		case 0b10000000:
-			/*
-			 * all other modes
-			 */
-
-			switch (postbyte & 0b00010000) {
-			case 0b00000000:
-				/*
-				 * non-indirect
-				 */
-
-				switch (postbyte & 0b00001111) {
-				case 0b0100:
-					/*
-					 * no offset
-					 * uses no extra cycles
-					 */
-
-					address = *index_regs[(postbyte & 0b01100000) >> 5];
-					break;
-				case 0b1000:
-					/*
-					 * 8-bit offset
-					 */
-					cycles += 1;
-
-					byte = read8(pc++);
-					if (byte & 0b10000000) {
-						offset = 0xff00 | byte;
-					} else {
-						offset = byte;
-					}
-					address = *index_regs[(postbyte & 0b01100000) >> 5]
-						+ offset;
-					break;
-				case 0b1001:
-					/*
-					 * 16 bit offset
-					 */
-					cycles += 4;
-
-					offset = read8(pc++) << 8;
-					offset |= read8(pc++);
-					address = *index_regs[(postbyte & 0b01100000) >> 5]
-						+ offset;
-					break;
-				case 0b0110:
-					/*
-					 * accumulator a offset
-					 */
-					cycles += 1;
-
-					if (ac & 0b10000000) {
-						offset = 0xff00 | ac;
-					} else {
-						offset = ac;
-					}
-					address = *index_regs[(postbyte & 0b01100000) >> 5]
-						+ offset;
-					break;
-				case 0b0101:
-					/*
-					 * accumulator b offset
-					 */
-					cycles += 1;
-
-					if (br & 0b10000000) {
-						offset = 0xff00 | br;
-					} else {
-						offset = br;
-					}
-					address = *index_regs[(postbyte & 0b01100000) >> 5]
-						+ offset;
-					break;
-				case 0b1011:
-					/*
-					 * accumulator d offset
-					 */
-					cycles += 4;
-
-					offset = (ac << 8) | br;
-					address = *index_regs[(postbyte & 0b01100000) >> 5]
-						+ offset;
-					break;
-				case 0b0000:
-					/*
-					 * auto increment by 1
-					 */
-					cycles += 2;
-
-					address = *index_regs[(postbyte & 0b01100000) >> 5];
-					(*index_regs[(postbyte & 0b01100000) >> 5])++;
-					break;
-				case 0b0001:
-					/*
-					 * auto increment by 2
-					 */
-					cycles += 3;
-
-					address = *index_regs[(postbyte & 0b01100000) >> 5];
-					(*index_regs[(postbyte & 0b01100000) >> 5]) += 2;
-					break;
-				case 0b0010:
-					/*
-					 * auto decrement by 1
-					 */
-					cycles += 2;
-
-					(*index_regs[(postbyte & 0b01100000) >> 5])--;
-					address = *index_regs[(postbyte & 0b01100000) >> 5];
-					break;
-				case 0b0011:
-					/*
-					 * auto decrement by 2
-					 */
-					cycles += 3;
-
-					(*index_regs[(postbyte & 0b01100000) >> 5]) -= 2;
-					address = *index_regs[(postbyte & 0b01100000) >> 5];
-					break;
-				case 0b1100:
-					/*
-					 * constant offset pc 8bit, reads extra byte
-					 */
-					cycles += 1;
-
-					byte = read8(pc++);
-					if (byte & 0b10000000) {
-						offset = 0xff00 | byte;
-					} else {
-						offset = byte;
-					}
-					address = pc + offset;
-					break;
-				case 0b1101:
-					/*
-					 * constant offset pc 16bit, reads 2 extra bytes
-					 */
-					cycles += 5;
-
-					offset = read8(pc++) << 8;
-					offset |= read8(pc++);
-					address = pc + offset;
-					break;
-				default:
-					// TODO
-					// all others are illegal
-					*legal = false;
-					break;
-				}
-				break;
-			case 0b00010000:
-				/*
-				 * indirect
-				 */
-
-				switch (postbyte & 0b00001111) {
-				case 0b0100:
-					/*
-					 * indirect, no offset
-					 */
-					cycles += 3;
-
-					word = *index_regs[(postbyte & 0b01100000) >> 5];
-					address = read8(word++) << 8;
-					address |= read8(word);
-					break;
-				case 0b1000:
-					/*
-					 * indirect, 8-bit offset
-					 */
-					cycles += 4;
-
-					byte = read8(pc++);
-					if (byte & 0b10000000) {
-						offset = 0xff00 | byte;
-					} else {
-						offset = byte;
-					}
-					word = *index_regs[(postbyte & 0b01100000) >> 5]
-						+ offset;
-					address = read8(word++) << 8;
-					address |= read8(word);
-					break;
-				case 0b1001:
-					/*
-					 * indirect, 16-bit offset
-					 */
-					cycles += 7;
+		}
+		// fall through
+	default:
+		d.offset = IDX_ILLEGAL;
+		return d;
+	}
 
-					offset = read8(pc++) << 8;
-					offset |= read8(pc++);
-					word = *index_regs[(postbyte & 0b01100000) >> 5]
-						+ offset;
-					address = read8(word++) << 8;
-					address |= read8(word);
-					break;
-				case 0b0110:
-					/*
-					 * indirect accumulator a offset
-					 */
-					cycles += 4;
+	if (d.indirect) {
+		if (((d.offset == IDX_INCREMENT) || (d.offset == IDX_DECREMENT)) &&
+		    (d.constant == 1)) {
+			d.offset = IDX_ILLEGAL;
+			d.constant = 0;
+			d.cycles = 0;
+			d.indirect = false;
+			return d;
+		}
+		d.cycles += 3;
+	}
+	return d;
+}
 
-					if (ac & 0b10000000) {
-						offset = 0xff00 | ac;
-					} else {
-						offset = ac;
-					}
-					word = *index_regs[(postbyte & 0b01100000) >> 5]
-						+ offset;
-					address = read8(word++) << 8;
-					address |= read8(word);
-					break;
-				case 0b0101:
-					/*
-					 * indirect accumulator b offset
-					 */
-					cycles += 4;
+constexpr struct mc6809::index_postbytes mc6809::generate_index_postbytes()
+{
+	struct index_postbytes table = {};
 
-					if (br & 0b10000000) {
-						offset = 0xff00 | br;
-					} else {
-						offset = br;
-					}
-					word = *index_regs[(postbyte & 0b01100000) >> 5]
-						+ offset;
-					address = read8(word++) << 8;
-					address |= read8(word);
-					break;
-				case 0b1011:
-					/*
-					 * accumulator d offset
-					 */
-					cycles += 7;
+	for (int postbyte = 0; postbyte < 256; postbyte++) {
+		table.postbyte[postbyte] = decode_postbyte(postbyte);
+	}
+	return table;
+}
 
-					offset = (ac << 8) | br;
-					word = *index_regs[(postbyte & 0b01100000) >> 5]
-						+ offset;
-					address = read8(word++) << 8;
-					address |= read8(word);
-					break;
-				case 0b0001:
-					/*
-					 * indirect auto increment by 2
-					 */
-					cycles += 6;
+constexpr struct mc6809::index_postbytes mc6809::index_table = mc6809::generate_index_postbytes();
 
-					word = *index_regs[(postbyte & 0b01100000) >> 5];
-					(*index_regs[(postbyte & 0b01100000) >> 5]) += 2;
-					address = read8(word++) << 8;
-					address |= read8(word);
-					break;
-				case 0b0011:
-					/*
-					 * indirect auto decrement by 2
-					 */
-					cycles += 6;
+uint16_t mc6809::a_idx(bool *legal)
+{
+	const struct index_postbyte &p = index_table.postbyte[fetch8()];
+	uint16_t address;
 
-					(*index_regs[(postbyte & 0b01100000) >> 5]) -= 2;
-					word = *index_regs[(postbyte & 0b01100000) >> 5];
-					address = read8(word++) << 8;
-					address |= read8(word);
-					break;
-				case 0b1100:
-					/*
-					 * indirect constant offset pc 8bit, reads extra byte
-					 */
-					cycles += 4;
+	*legal = true;
+	cycles += p.cycles;
 
-					byte = read8(pc++);
-					if (byte & 0b10000000) {
-						offset = 0xff00 | byte;
-					} else {
-						offset = byte;
-					}
-					word = pc + offset;
-					address = read8(word++) << 8;
-					address |= read8(word);
-					break;
-				case 0b1101:
-					/*
-					 * indirect constant offset pc 16bit, reads 2 extra bytes
-					 */
-					cycles += 8;
+	/*
+	 * Operand bytes are fetched before the base register is read, pc
+	 * relative offsets are from the end of the instruction.
+	 */
+	switch (p.offset) {
+	case IDX_CONSTANT:
+		address = this->*p.reg + p.constant;
+		break;
+	case IDX_INCREMENT:
+		address = this->*p.reg;
+		this->*p.reg += p.constant;
+		break;
+	case IDX_DECREMENT:
+		address = (this->*p.reg -= p.constant);
+		break;
+	case IDX_8BIT:
+		address = (uint16_t)((int8_t)fetch8());
+		address += this->*p.reg;
+		break;
+	case IDX_16BIT:
+		address = fetch8() << 8;
+		address |= fetch8();
+		address += this->*p.reg;
+		break;
+	case IDX_A:
+		address = this->*p.reg + (uint16_t)((int8_t)ac);
+		break;
+	case IDX_B:
+		address = this->*p.reg + (uint16_t)((int8_t)br);
+		break;
+	case IDX_D:
+		address = this->*p.reg + ((ac << 8) | br);
+		break;
+	case IDX_EXTENDED:
+		address = fetch8() << 8;
+		address |= fetch8();
+		break;
+	default:
+		*legal = false;
+		return 0;
+	}
 
-					offset = read8(pc++) << 8;
-					offset |= read8(pc++);
-					word = pc + offset;
-					address = read8(word++) << 8;
-					address |= read8(word);
-					break;
-				default:
-					// TODO
-					// all others are illegal
-					*legal = false;
-					break;
-				}
-				break;
-			}
-			break;
-		};
+	if (p.indirect) {
+		uint16_t word = address;
+		address = bus_read8(word++) << 8;
+		address |= bus_read8(word);
 	}
 	return address;
 }
 
 uint16_t mc6809::a_ext(bool *legal)
 {
-	uint16_t word = (read8(pc++)) << 8;
-	word |= read8(pc++);
+	uint16_t word = (fetch8()) << 8;
+	word |= fetch8();
 	*legal = true;
 	return word;
 }
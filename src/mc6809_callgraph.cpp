@@ -0,0 +1,217 @@
+/*
+ * mc6809_callgraph.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Call graph profiler with callgrind format output
+ */
+
+#include "mc6809.hpp"
+#include <algorithm>
+#include <cstring>
+
+void mc6809::enable_callgraph(bool enable)
+{
+	if (enable) {
+		if (callgraph_self_cycles == NULL) {
+			callgraph_self_cycles = new uint64_t[65536]();
+			callgraph_owner = new uint32_t[65536]();
+		}
+		instruments |= INSTRUMENT_CALLGRAPH;
+	} else {
+		instruments &= ~INSTRUMENT_CALLGRAPH;
+	}
+}
+
+void mc6809::reset_callgraph()
+{
+	callgraph_stack.clear();
+	callgraph_edges.clear();
+	callgraph_shared_cycles.clear();
+	callgraph_cycles = 0;
+	if (callgraph_self_cycles) {
+		memset(callgraph_self_cycles, 0, 65536 * sizeof(uint64_t));
+		memset(callgraph_owner, 0, 65536 * sizeof(uint32_t));
+	}
+}
+
+/*
+ * Called after each instruction (or interrupt entry). Frames are
+ * matched by stack position instead of by instruction: a frame is done
+ * as soon as s rises above the return address (or state) pushed on
+ * entry. This covers rts, puls pc, rti, hle hooks and code that drops
+ * its return address with leas.
+ */
+void mc6809::callgraph_step(uint16_t consumed, uint16_t old_sp, bool interrupted)
+{
+	uint32_t current = callgraph_stack.empty() ?
+		CALLGRAPH_ROOT : callgraph_stack.back().function;
+
+	callgraph_cycles += consumed;
+	if ((callgraph_self_cycles[instruction_pc] == 0) ||
+	    (callgraph_owner[instruction_pc] == current)) {
+		callgraph_self_cycles[instruction_pc] += consumed;
+		callgraph_owner[instruction_pc] = current;
+	} else {
+		callgraph_shared_cycles[((uint64_t)current << 16) | instruction_pc] += consumed;
+	}
+
+	while (!callgraph_stack.empty() && (callgraph_stack.back().sp < sp)) {
+		callgraph_return(callgraph_stack.back());
+		callgraph_stack.pop_back();
+	}
+
+	bool entered = interrupted;
+
+	if (!entered && (fetched_bytes == 0)) {
+		/*
+		 * hle hook or sync/cwai wait, nothing is called
+		 */
+	} else if (!entered && (sp == (uint16_t)(old_sp - 2))) {
+		/*
+		 * jsr, bsr or lbsr, told by the fetched opcode
+		 */
+		switch (fetched[0]) {
+		case 0x17:
+		case 0x8d:
+		case 0x9d:
+		case 0xad:
+		case 0xbd:
+			entered = true;
+			break;
+		}
+	} else if (!entered && (sp < (uint16_t)(old_sp - 2))) {
+		/*
+		 * swi, swi2 and swi3 push the entire state
+		 */
+		uint8_t opcode = fetched[0];
+		if ((opcode == 0x10) || (opcode == 0x11)) {
+			opcode = fetched[1];
+		}
+		entered = (opcode == 0x3f);
+	}
+
+	if (entered) {
+		if (callgraph_stack.size() == CALLGRAPH_MAX_DEPTH) {
+			callgraph_stack.erase(callgraph_stack.begin());
+		}
+		struct callgraph_frame frame;
+		frame.function = pc;
+		frame.caller = current;
+		frame.call_site = instruction_pc;
+		frame.sp = sp;
+		frame.entry_cycles = callgraph_cycles;
+		frame.callee_cycles = 0;
+		callgraph_stack.push_back(frame);
+	}
+}
+
+/*
+ * Called for the frame on top of the stack, before it's popped. Its
+ * inclusive cycles count as callee cycles of the frame below.
+ */
+void mc6809::callgraph_return(struct callgraph_frame &frame)
+{
+	uint64_t key = ((uint64_t)frame.caller << 32) |
+		((uint64_t)frame.call_site << 16) | frame.function;
+	uint64_t inclusive = callgraph_cycles - frame.entry_cycles;
+	struct callgraph_edge &edge = callgraph_edges[key];
+	edge.calls++;
+	edge.inclusive_cycles += inclusive;
+	edge.exclusive_cycles += inclusive - frame.callee_cycles;
+	if (callgraph_stack.size() > 1) {
+		callgraph_stack[callgraph_stack.size() - 2].callee_cycles += inclusive;
+	}
+}
+
+/*
+ * Positions are guest addresses, self cost is per instruction and per
+ * function it executed in. Calls still on the shadow stack are not
+ * included.
+ */
+bool mc6809::write_callgrind(const char *filename)
+{
+	if (callgraph_self_cycles == NULL) return false;
+
+	FILE *f = fopen(filename, "w");
+	if (f == NULL) return false;
+
+	fprintf(f, "# callgrind format\n");
+	fprintf(f, "version: 1\n");
+	fprintf(f, "creator: MC6809 %i.%i.%i\n", MC6809_MAJOR_VERSION,
+		MC6809_MINOR_VERSION, MC6809_BUILD);
+	fprintf(f, "positions: instr\n");
+	fprintf(f, "events: Cycles\n");
+	fprintf(f, "summary: %llu\n\n", (unsigned long long)callgraph_cycles);
+
+	/*
+	 * All functions, sorted
+	 */
+	std::vector<uint32_t> functions;
+	for (int i=0; i<65536; i++) {
+		if (callgraph_self_cycles[i]) functions.push_back(callgraph_owner[i]);
+	}
+	for (auto &c : callgraph_shared_cycles) {
+		functions.push_back(c.first >> 16);
+	}
+	for (auto &e : callgraph_edges) {
+		functions.push_back(e.first >> 32);
+	}
+	std::sort(functions.begin(), functions.end());
+	functions.erase(std::unique(functions.begin(), functions.end()), functions.end());
+
+	char name[64];
+	for (uint32_t function : functions) {
+		function_name(name, sizeof(name), function);
+		fprintf(f, "fn=%s\n", name);
+		auto shared = callgraph_shared_cycles.lower_bound((uint64_t)function << 16);
+		for (int i=0; i<65536; i++) {
+			uint64_t self = (callgraph_owner[i] == function) ?
+				callgraph_self_cycles[i] : 0;
+			if ((shared != callgraph_shared_cycles.end()) &&
+			    (shared->first == (((uint64_t)function << 16) | i))) {
+				self = (shared++)->second;
+			}
+			if (self) fprintf(f, "0x%04x %llu\n", i, (unsigned long long)self);
+		}
+		/*
+		 * Edges are keyed by caller first, so they are found in
+		 * one range.
+		 */
+		for (auto e = callgraph_edges.lower_bound((uint64_t)function << 32);
+		     (e != callgraph_edges.end()) && ((e->first >> 32) == function); e++) {
+			uint16_t call_site = (e->first >> 16) & 0xffff;
+			uint16_t callee = e->first & 0xffff;
+			function_name(name, sizeof(name), callee);
+			fprintf(f, "cfn=%s\n", name);
+			fprintf(f, "calls=%llu 0x%04x\n",
+				(unsigned long long)e->second.calls, callee);
+			fprintf(f, "0x%04x %llu\n", call_site,
+				(unsigned long long)e->second.inclusive_cycles);
+		}
+		fprintf(f, "\n");
+	}
+
+	fclose(f);
+	return true;
+}
+
+/*
+ * One line per call edge. Exclusive cycles are the inclusive cycles of
+ * the calls minus those of the functions they called in turn.
+ */
+void mc6809::callgraph_csv(FILE *f)
+{
+	char caller[64], callee[64];
+
+	fprintf(f, "caller,call_site,callee,calls,inclusive_cycles,exclusive_cycles\n");
+	for (auto &e : callgraph_edges) {
+		function_name(caller, sizeof(caller), e.first >> 32);
+		function_name(callee, sizeof(callee), e.first & 0xffff);
+		fprintf(f, "\"%s\",$%04x,\"%s\",%llu,%llu,%llu\n", caller,
+			(unsigned)((e.first >> 16) & 0xffff), callee,
+			(unsigned long long)e.second.calls,
+			(unsigned long long)e.second.inclusive_cycles,
+			(unsigned long long)e.second.exclusive_cycles);
+	}
+}
@@ -0,0 +1,187 @@
+/*
+ * mc6809_coverage.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Instruction and branch coverage
+ */
+
+#include "mc6809.hpp"
+#include <cstring>
+
+#define	COVERAGE_BYTES	8192
+
+void mc6809::enable_coverage(bool enable)
+{
+	if (enable) {
+		if (coverage_executed == NULL) {
+			/*
+			 * One allocation for all four bitmaps
+			 */
+			coverage_executed = new uint8_t[4 * COVERAGE_BYTES]();
+			coverage_taken = coverage_executed + COVERAGE_BYTES;
+			coverage_not_taken = coverage_taken + COVERAGE_BYTES;
+			coverage_done = coverage_not_taken + COVERAGE_BYTES;
+		}
+		instruments |= INSTRUMENT_COVERAGE;
+	} else {
+		instruments &= ~INSTRUMENT_COVERAGE;
+	}
+}
+
+void mc6809::reset_coverage()
+{
+	if (coverage_executed) memset(coverage_executed, 0, 4 * COVERAGE_BYTES);
+}
+
+/*
+ * Length of the conditional branch at address (2 or 4), or 0 if it's
+ * something else. Branch opcodes are peeked with read8().
+ */
+static int conditional_branch(const mc6809 *cpu, uint16_t address, uint8_t *condition)
+{
+	uint8_t opcode = cpu->read8(address);
+	int length = 2;
+
+	if (opcode == 0x10) {
+		opcode = cpu->read8(address + 1);
+		length = 4;
+	}
+	if ((opcode & 0xf0) != 0x20 || (opcode & 0x0f) < 0x02) return 0;
+	*condition = opcode & 0x0f;
+	return length;
+}
+
+void mc6809::coverage_instruction()
+{
+	uint16_t byte = instruction_pc >> 3;
+	uint8_t bit = 1 << (instruction_pc & 0b111);
+
+	coverage_executed[byte] |= bit;
+
+	/*
+	 * Branches don't change cc, so the condition is evaluated with the
+	 * flags after the instruction.
+	 */
+	uint8_t condition;
+	if (conditional_branch(this, instruction_pc, &condition)) {
+		if (branch_table.taken[cc] & (1 << condition)) {
+			coverage_taken[byte] |= bit;
+		} else {
+			coverage_not_taken[byte] |= bit;
+		}
+		if (coverage_taken[byte] & coverage_not_taken[byte] & bit) {
+			coverage_done[byte] |= bit;
+		}
+	} else {
+		coverage_done[byte] |= bit;
+	}
+}
+
+/*
+ * File format: magic, then the executed, taken and not taken bitmaps
+ */
+bool mc6809::save_coverage(const char *filename)
+{
+	if (coverage_executed == NULL) return false;
+
+	FILE *f = fopen(filename, "wb");
+	if (f == NULL) return false;
+
+	bool ok = (fwrite(COVERAGE_MAGIC, 8, 1, f) == 1) &&
+		(fwrite(coverage_executed, 3 * COVERAGE_BYTES, 1, f) == 1);
+	fclose(f);
+	return ok;
+}
+
+bool mc6809::merge_coverage(const char *filename)
+{
+	FILE *f = fopen(filename, "rb");
+	if (f == NULL) return false;
+
+	char magic[8];
+	uint8_t *bitmaps = new uint8_t[3 * COVERAGE_BYTES];
+	bool ok = (fread(magic, 8, 1, f) == 1) &&
+		(memcmp(magic, COVERAGE_MAGIC, 8) == 0) &&
+		(fread(bitmaps, 3 * COVERAGE_BYTES, 1, f) == 1);
+	fclose(f);
+
+	if (ok) {
+		/*
+		 * Allocates the bitmaps if needed, without enabling
+		 */
+		uint32_t enabled = instruments;
+		enable_coverage(true);
+		instruments = enabled;
+		for (int i=0; i<3 * COVERAGE_BYTES; i++) {
+			coverage_executed[i] |= bitmaps[i];
+		}
+	}
+
+	delete [] bitmaps;
+	return ok;
+}
+
+void mc6809::coverage_listing(FILE *f, uint16_t start, uint16_t end)
+{
+	if (coverage_executed == NULL) return;
+
+	char text[64];
+	uint32_t address = start;
+
+	while (address <= end) {
+		uint16_t byte = address >> 3;
+		uint8_t bit = 1 << (address & 0b111);
+
+		if (const char *label = get_symbol(address)) {
+			fprintf(f, "%s:\n", label);
+		}
+
+		uint8_t condition;
+		const char *branch = "  ";
+		if (conditional_branch(this, address, &condition)) {
+			bool taken = coverage_taken[byte] & bit;
+			bool not_taken = coverage_not_taken[byte] & bit;
+			branch = taken ? (not_taken ? "tn" : "t-") : (not_taken ? "-n" : "--");
+		}
+
+		address += disassemble_instruction(text, sizeof(text), address);
+		fprintf(f, "%s %s %s\n", (coverage_executed[byte] & bit) ? "    " : "####",
+			branch, text);
+	}
+}
+
+void mc6809::coverage_summary(FILE *f, uint16_t start, uint16_t end)
+{
+	if (coverage_executed == NULL) return;
+
+	char text[64];
+	uint32_t address = start;
+	uint32_t instructions = 0, executed = 0;
+	uint32_t branches = 0, directions = 0;
+
+	while (address <= end) {
+		uint16_t byte = address >> 3;
+		uint8_t bit = 1 << (address & 0b111);
+
+		instructions++;
+		if (coverage_executed[byte] & bit) executed++;
+
+		uint8_t condition;
+		if (conditional_branch(this, address, &condition)) {
+			branches += 2;
+			if (coverage_taken[byte] & bit) directions++;
+			if (coverage_not_taken[byte] & bit) directions++;
+		}
+
+		address += disassemble_instruction(text, sizeof(text), address);
+	}
+
+	fprintf(f, "Summary coverage rate ($%04x-$%04x):\n", start, end);
+	fprintf(f, "  instructions..: %.1f%% (%u of %u instructions)\n",
+		instructions ? 100.0 * executed / instructions : 0.0,
+		executed, instructions);
+	fprintf(f, "  branches......: %.1f%% (%u of %u branches)\n",
+		branches ? 100.0 * directions / branches : 0.0,
+		directions, branches);
+}
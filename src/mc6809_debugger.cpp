@@ -0,0 +1,461 @@
+/*
+ * mc6809_debugger.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Breakpoints, conditional breakpoints and watchpoints
+ */
+
+#include "mc6809.hpp"
+#include <cstring>
+#include <cctype>
+
+bool mc6809::is_breakpoint(uint16_t address)
+{
+	if (breakpoint_bits == NULL) return false;
+	return breakpoint_bits[address >> 3] & (1 << (address & 0b111));
+}
+
+void mc6809::toggle_breakpoint(uint16_t address)
+{
+	if (breakpoint_bits == NULL) {
+		breakpoint_bits = new uint8_t[8192]();
+	}
+
+	uint8_t mask = 1 << (address & 0b111);
+	breakpoint_bits[address >> 3] ^= mask;
+	if (breakpoint_bits[address >> 3] & mask) {
+		breakpoints_armed++;
+	} else {
+		breakpoints_armed--;
+		remove_breakpoint_condition(address);
+	}
+}
+
+void mc6809::clear_breakpoints()
+{
+	if (breakpoint_bits) {
+		memset(breakpoint_bits, 0, 8192);
+	}
+	breakpoints_armed = 0;
+	breakpoint_conditions.clear();
+}
+
+/*
+ * Bytecode for breakpoint conditions. Each instruction is a uint32_t
+ * with the opcode in the upper and an operand in the lower 16 bits.
+ * Constants above $ffff are a BP_CONST32 followed by the value as a
+ * word of its own. It runs on a small stack machine.
+ */
+enum bp_opcode {
+	BP_CONST,	// push operand
+	BP_CONST32,	// push the next code word
+	BP_REG,		// push register (operand = bp_register)
+	BP_FLAG,	// push 1 if flag (operand = mask) in cc is set
+	BP_HITS,	// push hit count
+	BP_MEM,		// replace top of stack by memory byte at that address
+	BP_NOT,
+	BP_BITAND,
+	BP_EQ,
+	BP_NE,
+	BP_LT,
+	BP_LE,
+	BP_GT,
+	BP_GE,
+	BP_AND,
+	BP_OR
+};
+
+enum bp_register {
+	BP_PC, BP_AC, BP_BR, BP_DR, BP_XR, BP_YR, BP_US, BP_SP, BP_DP, BP_CC
+};
+
+#define BP_STACK_SIZE	16
+
+struct bp_name {
+	const char *name;
+	enum bp_opcode opcode;
+	uint16_t operand;
+};
+
+static const struct bp_name bp_names[] = {
+	{ "pc",   BP_REG,  BP_PC },
+	{ "a",    BP_REG,  BP_AC },
+	{ "b",    BP_REG,  BP_BR },
+	{ "d",    BP_REG,  BP_DR },
+	{ "x",    BP_REG,  BP_XR },
+	{ "y",    BP_REG,  BP_YR },
+	{ "u",    BP_REG,  BP_US },
+	{ "s",    BP_REG,  BP_SP },
+	{ "dp",   BP_REG,  BP_DP },
+	{ "cc",   BP_REG,  BP_CC },
+	{ "cc.e", BP_FLAG, E_FLAG },
+	{ "cc.f", BP_FLAG, F_FLAG },
+	{ "cc.h", BP_FLAG, H_FLAG },
+	{ "cc.i", BP_FLAG, I_FLAG },
+	{ "cc.n", BP_FLAG, N_FLAG },
+	{ "cc.z", BP_FLAG, Z_FLAG },
+	{ "cc.v", BP_FLAG, V_FLAG },
+	{ "cc.c", BP_FLAG, C_FLAG },
+	{ "hits", BP_HITS, 0 }
+};
+
+/*
+ * Recursive descent compiler, precedence from low to high:
+ * ||, &&, comparisons, &, ! and primaries.
+ */
+class bp_compiler {
+public:
+	bp_compiler(const char *text, std::vector<uint32_t> *code) :
+		p(text), code(code), depth(0), error(false) {}
+
+	bool compile() {
+		or_expr();
+		skip_spaces();
+		return !error && (*p == '\0') && (depth == 1);
+	}
+private:
+	const char *p;
+	std::vector<uint32_t> *code;
+	int depth;
+	bool error;
+
+	void skip_spaces() { while (*p == ' ' || *p == '\t') p++; }
+
+	bool accept(const char *token) {
+		skip_spaces();
+		size_t n = strlen(token);
+		if (strncmp(p, token, n) == 0) {
+			p += n;
+			return true;
+		}
+		return false;
+	}
+
+	void emit(enum bp_opcode opcode, uint16_t operand = 0) {
+		switch (opcode) {
+		case BP_CONST:
+		case BP_CONST32:
+		case BP_REG:
+		case BP_FLAG:
+		case BP_HITS:
+			depth++;
+			break;
+		case BP_MEM:
+		case BP_NOT:
+			break;
+		default:
+			depth--;
+			break;
+		}
+		if (depth > BP_STACK_SIZE) error = true;
+		code->push_back((opcode << 16) | operand);
+	}
+
+	void or_expr() {
+		and_expr();
+		while (!error && accept("||")) {
+			and_expr();
+			emit(BP_OR);
+		}
+	}
+
+	void and_expr() {
+		cmp_expr();
+		while (!error && accept("&&")) {
+			cmp_expr();
+			emit(BP_AND);
+		}
+	}
+
+	void cmp_expr() {
+		bit_expr();
+		enum bp_opcode opcode;
+		if (accept("==")) opcode = BP_EQ;
+		else if (accept("!=")) opcode = BP_NE;
+		else if (accept("<=")) opcode = BP_LE;
+		else if (accept(">=")) opcode = BP_GE;
+		else if (accept("<")) opcode = BP_LT;
+		else if (accept(">")) opcode = BP_GT;
+		else return;
+		bit_expr();
+		emit(opcode);
+	}
+
+	void bit_expr() {
+		unary();
+		for (;;) {
+			skip_spaces();
+			if (error || (p[0] != '&') || (p[1] == '&')) return;
+			p++;
+			unary();
+			emit(BP_BITAND);
+		}
+	}
+
+	void unary() {
+		skip_spaces();
+		if ((p[0] == '!') && (p[1] != '=')) {
+			p++;
+			unary();
+			emit(BP_NOT);
+		} else {
+			primary();
+		}
+	}
+
+	void primary() {
+		skip_spaces();
+		if (*p == '(') {
+			p++;
+			or_expr();
+			if (!accept(")")) error = true;
+		} else if (*p == '[') {
+			p++;
+			or_expr();
+			if (!accept("]")) error = true;
+			emit(BP_MEM);
+		} else if (*p == '$') {
+			p++;
+			number(16);
+		} else if (isdigit((unsigned char)*p)) {
+			if ((p[0] == '0') && ((p[1] == 'x') || (p[1] == 'X'))) {
+				p += 2;
+				number(16);
+			} else {
+				number(10);
+			}
+		} else if (isalpha((unsigned char)*p)) {
+			char name[8];
+			int n = 0;
+			while ((isalpha((unsigned char)*p) || (*p == '.')) && (n < 7)) {
+				name[n++] = tolower((unsigned char)*p++);
+			}
+			name[n] = '\0';
+			for (size_t i=0; i<sizeof(bp_names)/sizeof(bp_names[0]); i++) {
+				if (strcmp(name, bp_names[i].name) == 0) {
+					emit(bp_names[i].opcode, bp_names[i].operand);
+					return;
+				}
+			}
+			error = true;
+		} else {
+			error = true;
+		}
+	}
+
+	void number(int base) {
+		uint64_t value = 0;
+		int digits = 0;
+		for (;;) {
+			int c = tolower((unsigned char)*p);
+			int digit;
+			if (c >= '0' && c <= '9') digit = c - '0';
+			else if (base == 16 && c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+			else break;
+			value = (value * base) + digit;
+			if (value > 0xffffffff) error = true;
+			digits++;
+			p++;
+		}
+		if (digits == 0) error = true;
+		if (value > 0xffff) {
+			emit(BP_CONST32);
+			code->push_back(value);
+		} else {
+			emit(BP_CONST, value);
+		}
+	}
+};
+
+bool mc6809::set_conditional_breakpoint(uint16_t address, const char *condition)
+{
+	struct breakpoint_condition bc;
+	bc.address = address;
+	bc.hits = 0;
+	snprintf(bc.text, sizeof(bc.text), "%s", condition);
+
+	bp_compiler compiler(condition, &bc.code);
+	if (!compiler.compile()) return false;
+
+	if (!is_breakpoint(address)) toggle_breakpoint(address);
+	remove_breakpoint_condition(address);
+	breakpoint_conditions.push_back(bc);
+	if (address == breakpoint_pc) breakpoint_reached = false;
+	return true;
+}
+
+const char *mc6809::get_breakpoint_condition(uint16_t address)
+{
+	for (size_t i=0; i<breakpoint_conditions.size(); i++) {
+		if (breakpoint_conditions[i].address == address) {
+			return breakpoint_conditions[i].text;
+		}
+	}
+	return NULL;
+}
+
+void mc6809::remove_breakpoint_condition(uint16_t address)
+{
+	for (size_t i=0; i<breakpoint_conditions.size(); i++) {
+		if (breakpoint_conditions[i].address == address) {
+			breakpoint_conditions.erase(breakpoint_conditions.begin() + i);
+			return;
+		}
+	}
+}
+
+/*
+ * Conditions are only evaluated by execute(), on arrival at pc. Without
+ * an arrival (after reset(), set_pc() or toggling a breakpoint on the
+ * current pc) only an unconditional breakpoint counts as reached.
+ */
+bool mc6809::breakpoint_condition_met()
+{
+	if (get_breakpoint_condition(pc) == NULL) return true;
+	return breakpoint_reached && (breakpoint_pc == pc);
+}
+
+/*
+ * Called by execute() when pc arrived at an armed address. Returns true
+ * for unconditional breakpoints and for conditions that are met.
+ */
+bool mc6809::check_breakpoint_condition()
+{
+	struct breakpoint_condition *bc = NULL;
+	for (size_t i=0; i<breakpoint_conditions.size(); i++) {
+		if (breakpoint_conditions[i].address == pc) {
+			bc = &breakpoint_conditions[i];
+			break;
+		}
+	}
+	if (bc == NULL) return true;
+
+	bc->hits++;
+
+	uint32_t stack[BP_STACK_SIZE];
+	int top = -1;
+
+	for (size_t i=0; i<bc->code.size(); i++) {
+		uint16_t operand = bc->code[i] & 0xffff;
+		switch (bc->code[i] >> 16) {
+		case BP_CONST:
+			stack[++top] = operand;
+			break;
+		case BP_CONST32:
+			stack[++top] = bc->code[++i];
+			break;
+		case BP_REG:
+			switch (operand) {
+			case BP_PC: stack[++top] = pc; break;
+			case BP_AC: stack[++top] = ac; break;
+			case BP_BR: stack[++top] = br; break;
+			case BP_DR: stack[++top] = (ac << 8) | br; break;
+			case BP_XR: stack[++top] = xr; break;
+			case BP_YR: stack[++top] = yr; break;
+			case BP_US: stack[++top] = us; break;
+			case BP_SP: stack[++top] = sp; break;
+			case BP_DP: stack[++top] = dp; break;
+			default:    stack[++top] = cc; break;
+			}
+			break;
+		case BP_FLAG:
+			stack[++top] = (cc & operand) ? 1 : 0;
+			break;
+		case BP_HITS:
+			stack[++top] = bc->hits;
+			break;
+		case BP_MEM:
+			stack[top] = read8(stack[top] & 0xffff);
+			break;
+		case BP_NOT:
+			stack[top] = !stack[top];
+			break;
+		case BP_BITAND: top--; stack[top] = stack[top] &  stack[top+1]; break;
+		case BP_EQ:     top--; stack[top] = stack[top] == stack[top+1]; break;
+		case BP_NE:     top--; stack[top] = stack[top] != stack[top+1]; break;
+		case BP_LT:     top--; stack[top] = stack[top] <  stack[top+1]; break;
+		case BP_LE:     top--; stack[top] = stack[top] <= stack[top+1]; break;
+		case BP_GT:     top--; stack[top] = stack[top] >  stack[top+1]; break;
+		case BP_GE:     top--; stack[top] = stack[top] >= stack[top+1]; break;
+		case BP_AND:    top--; stack[top] = stack[top] && stack[top+1]; break;
+		case BP_OR:     top--; stack[top] = stack[top] || stack[top+1]; break;
+		}
+	}
+	return stack[0] != 0;
+}
+
+void mc6809::add_watchpoint(uint16_t start, uint16_t end, uint8_t type)
+{
+	if (end < start) {
+		uint16_t temp = start;
+		start = end;
+		end = temp;
+	}
+	watchpoints.push_back({ start, end, (uint8_t)(type & (WATCH_READ | WATCH_WRITE)) });
+	update_watch_pages();
+}
+
+void mc6809::remove_watchpoint(uint16_t start, uint16_t end)
+{
+	for (size_t i=0; i<watchpoints.size(); ) {
+		if ((watchpoints[i].start == start) && (watchpoints[i].end == end)) {
+			watchpoints.erase(watchpoints.begin() + i);
+		} else {
+			i++;
+		}
+	}
+	update_watch_pages();
+}
+
+void mc6809::clear_watchpoints()
+{
+	watchpoints.clear();
+	update_watch_pages();
+}
+
+/*
+ * Rebuilds the per page flags that are tested by bus_read8() and
+ * bus_write8(). The heatmap needs to see all accesses.
+ */
+void mc6809::update_watch_pages()
+{
+	memset(watch_pages, (instruments & INSTRUMENT_HEATMAP) ?
+		(WATCH_READ | WATCH_WRITE) : 0, 256);
+	for (size_t i=0; i<watchpoints.size(); i++) {
+		for (int page = watchpoints[i].start >> 8; page <= (watchpoints[i].end >> 8); page++) {
+			watch_pages[page] |= watchpoints[i].type;
+		}
+	}
+}
+
+/*
+ * Slow path, only called for accesses to watched pages
+ */
+void mc6809::check_watchpoints(uint16_t address, uint8_t value, uint8_t type)
+{
+	if (instruments & INSTRUMENT_HEATMAP) {
+		if (type == WATCH_READ) {
+			heat_reads[address]++;
+			step_reads++;
+		} else {
+			heat_writes[address]++;
+			step_writes++;
+		}
+	}
+
+	for (size_t i=0; i<watchpoints.size(); i++) {
+		if ((watchpoints[i].type & type) &&
+		    (address >= watchpoints[i].start) &&
+		    (address <= watchpoints[i].end)) {
+			if (!watchpoint_triggered) {
+				watchpoint_triggered = true;
+				watch_hit.pc = instruction_pc;
+				watch_hit.address = address;
+				watch_hit.value = value;
+				watch_hit.type = type;
+			}
+			return;
+		}
+	}
+}
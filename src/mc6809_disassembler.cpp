@@ -13,73 +13,6 @@
 #include "mc6809.hpp"
 #include <cstdio>
 
-enum mnemonics_index {
-	__ABX=0,__ADCA, __ADCB, __ADDA, __ADDB, __ADDD, __ANDA, __ANDB,
-	__ANDCC,__ASL,  __ASLA, __ASLB, __ASR,  __ASRA, __ASRB, __BEQ,
-	__BGE,  __BGT,  __BHI,  __BHS,  __BITA, __BITB, __BMI,  __BLE,
-	__BLO,  __BLS,  __BLT,  __BNE,  __BPL,  __BRA,  __BRN,  __BSR,
-	__BVC,  __BVS,  __CLR,  __CLRA, __CLRB, __CMPA, __CMPB, __CMPD,
-	__CMPS, __CMPU, __CMPX, __CMPY, __COM,  __COMA, __COMB, __CWAI,
-	__DAA,  __DEC,  __DECA, __DECB, __EORA, __EORB, __EXG,  __ILL,
-	__INC,  __INCA, __INCB, __JMP,  __JSR,  __LBEQ, __LBGE, __LBGT,
-	__LBHI, __LBHS, __LBLE, __LBLO, __LBLS, __LBLT, __LBMI, __LBNE,
-	__LBPL, __LBRA, __LBRN, __LBSR, __LBVC, __LBVS, __LDA,  __LDB,
-	__LDD,  __LDS,  __LDU,  __LDX,  __LDY,  __LEAS, __LEAU, __LEAX,
-	__LEAY, __LSR,  __LSRA, __LSRB, __MUL,  __NEG,  __NEGA, __NEGB,
-	__NOP,  __ORA,  __ORB,  __ORCC, __PSHS, __PSHU, __PULS, __PULU,
-	__ROL,  __ROLA, __ROLB, __ROR,  __RORA, __RORB, __RTI,  __RTS,
-	__SBCA, __SBCB, __SEX,  __STA,  __STB,  __STD,  __STS,  __STU,
-	__STX,  __STY,  __SUBA, __SUBB, __SUBD, __SWI,  __SWI2, __SWI3,
-	__SYNC, __TFR,  __TST,  __TSTA, __TSTB
-};
-
-enum addr_mode_index {
-	__DIR_,	// direct
-	__NOM_,	// no mode
-	__REB_,	// relative byte
-	__REW_,	// relative word
-	__IMB_,	// immediate byte
-	__IMW_,	// immediate word
-	__IBB_,	// immediate byte binary (for andcc and orcc)
-	__EXT_,	// extended
-	__INH_,	// inherent
-	__R1_,	// tfr/exg mode
-	__R2_,	// pul/psh system
-	__R3_,	// pul/psh user
-	__IDX_,	// indexed
-
-
-	// __BD_,	// Bit Manipulation direct	// 6309??
-	// __BI_,	// Bit Manipulation index	// 6309??
-	// __BE_,	// Bit Manipulation extended	// 6309??
-	// __BT_,	// Bit Transfers direct		// 6309??
-	// __T1_,	// Block Transfer r0+,r1+	// 6309??
-	// __T2_,	// Block Transfer r0-,r1-	// 6309??
-	// __T3_,	// Block Transfer r0+,r1	// 6309??
-	// __T4_,	// Block Transfer r0,r1+	// 6309??
-	// __IML_ 	// immediate 32-bit		// 6309??
-};
-
-const char *mnemonics[133] = {
-	"abx  ","adca ","adcb ","adda ","addb ","addd ","anda ","andb ",
-	"andcc","asl  ","asla ","aslb ","asr  ","asra ","asrb ","beq  ",
-	"bge  ","bgt  ","bhi  ","bhs  ","bita ","bitb ","bmi  ","ble  ",
-	"blo  ","bls  ","blt  ","bne  ","bpl  ","bra  ","brn  ","bsr  ",
-	"bvc  ","bvs  ","clr  ","clra ","clrb ","cmpa ","cmpb ","cmpd ",
-	"cmps ","cmpu ","cmpx ","cmpy ","com  ","coma ","comb ","cwai ",
-	"daa  ","dec  ","deca ","decb ","eora ","eorb ","exg  ","???  ",
-	"inc  ","inca ","incb ","jmp  ","jsr  ","lbeq ","lbge ","lbgt ",
-	"lbhi ","lbhs ","lble ","lblo ","lbls ","lblt ","lbmi ","lbne ",
-	"lbpl ","lbra ","lbrn ","lbsr ","lbvc ","lbvs ","lda  ","ldb  ",
-	"ldd  ","lds  ","ldu  ","ldx  ","ldy  ","leas ","leau ","leax ",
-	"leay ","lsr  ","lsra ","lsrb ","mul  ","neg  ","nega ","negb ",
-	"nop  ","ora  ","orb  ","orcc ","pshs ","pshu ","puls ","pulu ",
-	"rol  ","rola ","rolb ","ror  ","rora ","rorb ","rti  ","rts  ",
-	"sbca ","sbcb ","sex  ","sta  ","stb  ","std  ","sts  ","stu  ",
-	"stx  ","sty  ","suba ","subb ","subd ","swi  ","swi2 ","swi3 ",
-	"sync ","tfr  ","tst  ","tsta ","tstb "
-};
-
 struct exg_tfr_operand {
 	char name[3];
 	bool illegal;
@@ -105,216 +38,6 @@ const struct exg_tfr_operand exg_tfr_operands[16] = {
 	{ "?",  true,  false }
 };
 
-enum mnemonics_index opcodes_page_1[256] = {
-	__NEG,	__ILL,	__ILL,	__COM,	__LSR,	__ILL,	__ROR,	__ASR,	// 0x00
-	__ASL,	__ROL,	__DEC,	__ILL,	__INC,	__TST,	__JMP,	__CLR,
-	__ILL,	__ILL,	__NOP,	__SYNC,	__ILL,	__ILL,	__LBRA,	__LBSR,	// 0x10
-	__ILL,	__DAA,	__ORCC,	__ILL,	__ANDCC,__SEX,	__EXG,	__TFR,
-	__BRA,	__BRN,	__BHI,	__BLS,	__BHS,	__BLO,	__BNE,	__BEQ,	// 0x20
-	__BVC,	__BVS,	__BPL,	__BMI,	__BGE,	__BLT,	__BGT,	__BLE,
-	__LEAX,	__LEAY,	__LEAS,	__LEAU,	__PSHS,	__PULS,	__PSHU,	__PULU,	// 0x30
-	__ILL,	__RTS,	__ABX,	__RTI,	__CWAI,	__MUL,	__ILL,	__SWI,
-	__NEGA,	__ILL,	__ILL,	__COMA,	__LSRA,	__ILL,	__RORA,	__ASRA,	// 0x40
-	__ASLA,	__ROLA,	__DECA,	__ILL,	__INCA,	__TSTA,	__ILL,	__CLRA,
-	__NEGB,	__ILL,	__ILL,	__COMB,	__LSRB,	__ILL,	__RORB,	__ASRB,	// 0x50
-	__ASLB,	__ROLB,	__DECB,	__ILL,	__INCB,	__TSTB,	__ILL,	__CLRB,
-	__NEG,	__ILL,	__ILL,	__COM,	__LSR,	__ILL,	__ROR,	__ASR,	// 0x60
-	__ASL,	__ROL,	__DEC,	__ILL,	__INC,	__TST,	__JMP,	__CLR,
-	__NEG,	__ILL,	__ILL,	__COM,	__LSR,	__ILL,	__ROR,	__ASR,	// 0x70
-	__ASL,	__ROL,	__DEC,	__ILL,	__INC,	__TST,	__JMP,	__CLR,
-	__SUBA,	__CMPA,	__SBCA,	__SUBD,	__ANDA,	__BITA,	__LDA,	__ILL,	// 0x80
-	__EORA,	__ADCA,	__ORA,	__ADDA,	__CMPX,	__BSR,	__LDX,	__ILL,
-	__SUBA,	__CMPA,	__SBCA,	__SUBD,	__ANDA,	__BITA,	__LDA,	__STA,	// 0x90
-	__EORA,	__ADCA,	__ORA,	__ADDA,	__CMPX,	__JSR,	__LDX,	__STX,
-	__SUBA,	__CMPA,	__SBCA,	__SUBD,	__ANDA,	__BITA,	__LDA,	__STA,	// 0xa0
-	__EORA,	__ADCA,	__ORA,	__ADDA,	__CMPX,	__JSR,	__LDX,	__STX,
-	__SUBA,	__CMPA,	__SBCA,	__SUBD,	__ANDA,	__BITA,	__LDA,	__STA,	// 0xb0
-	__EORA,	__ADCA,	__ORA,	__ADDA,	__CMPX,	__JSR,	__LDX,	__STX,
-	__SUBB,	__CMPB,	__SBCB,	__ADDD,	__ANDB,	__BITB,	__LDB,	__ILL,	// 0xc0
-	__EORB,	__ADCB,	__ORB,	__ADDB,	__LDD,	__ILL,	__LDU,	__ILL,
-	__SUBB,	__CMPB,	__SBCB,	__ADDD,	__ANDB,	__BITB,	__LDB,	__STB,	// 0xd0
-	__EORB,	__ADCB,	__ORB,	__ADDB,	__LDD,	__STD,	__LDU,	__STU,
-	__SUBB,	__CMPB,	__SBCB,	__ADDD,	__ANDB,	__BITB,	__LDB,	__STB,	// 0xe0
-	__EORB,	__ADCB,	__ORB,	__ADDB,	__LDD,	__STD,	__LDU,	__STU,
-	__SUBB,	__CMPB,	__SBCB,	__ADDD,	__ANDB,	__BITB,	__LDB,	__STB,	// 0xf0
-	__EORB,	__ADCB,	__ORB,	__ADDB,	__LDD,	__STD,	__LDU,	__STU
-};
-
-enum mnemonics_index opcodes_page_2[256] = {
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x00
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x10
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__LBRN,	__LBHI,	__LBLS,	__LBHS,	__LBLO,	__LBNE,	__LBEQ,	// 0x20
-	__LBVC,	__LBVS,	__LBPL,	__LBMI,	__LBGE,	__LBLT,	__LBGT,	__LBLE,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x30
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__SWI2,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x40
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x50
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x60
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x70
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__CMPD,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x80
-	__ILL,	__ILL,	__ILL,	__ILL,	__CMPY,	__ILL,	__LDY,	__ILL,
-	__ILL,	__ILL,	__ILL,	__CMPD,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x90
-	__ILL,	__ILL,	__ILL,	__ILL,	__CMPY,	__ILL,	__LDY,	__STY,
-	__ILL,	__ILL,	__ILL,	__CMPD,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xa0
-	__ILL,	__ILL,	__ILL,	__ILL,	__CMPY,	__ILL,	__LDY,	__STY,
-	__ILL,	__ILL,	__ILL,	__CMPD,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xb0
-	__ILL,	__ILL,	__ILL,	__ILL,	__CMPY,	__ILL,	__LDY,	__STY,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xc0
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__LDS,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xd0
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__LDS,	__STS,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xe0
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__LDS,	__STS,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xf0
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__LDS,	__STS
-};
-
-enum mnemonics_index opcodes_page_3[256] = {
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x00
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x10
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x20
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x30
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__SWI3,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x40
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x50
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x60
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x70
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__CMPU,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x80
-	__ILL,	__ILL,	__ILL,	__ILL,	__CMPS,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__CMPU,	__ILL,	__ILL,	__ILL,	__ILL,	// 0x90
-	__ILL,	__ILL,	__ILL,	__ILL,	__CMPS,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__CMPU,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xa0
-	__ILL,	__ILL,	__ILL,	__ILL,	__CMPS,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__CMPU,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xb0
-	__ILL,	__ILL,	__ILL,	__ILL,	__CMPS,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xc0
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xd0
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xe0
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	// 0xf0
-	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL,	__ILL
-};
-
-enum addr_mode_index addr_mode_page_1[256] = {
-	__DIR_, __NOM_, __NOM_, __DIR_, __DIR_, __NOM_, __DIR_,	__DIR_,	// 0x00
-	__DIR_, __DIR_, __DIR_, __NOM_, __DIR_, __DIR_, __NOM_, __DIR_,
-	__NOM_, __NOM_, __INH_, __INH_, __NOM_, __NOM_, __REW_, __REW_,	// 0x10
-	__NOM_, __INH_, __IBB_, __NOM_, __IBB_, __INH_, __R1_, 	__R1_,
-	__REB_, __REB_, __REB_, __REB_, __REB_, __REB_, __REB_, __REB_,	// 0x20
-	__REB_, __REB_, __REB_, __REB_, __REB_, __REB_, __REB_, __REB_,
-	__IDX_, __IDX_, __IDX_, __IDX_, __R2_,  __R2_,  __R3_,  __R3_,	// 0x30
-	__NOM_, __INH_, __INH_, __INH_, __IMB_, __INH_, __NOM_, __INH_,
-	__INH_, __NOM_, __NOM_, __INH_, __INH_, __NOM_, __INH_, __INH_,	// 0x40
-	__INH_, __INH_, __INH_, __NOM_, __INH_, __INH_, __NOM_, __INH_,
-	__INH_, __NOM_, __NOM_, __INH_, __INH_, __NOM_, __INH_, __INH_,	// 0x50
-	__INH_, __INH_, __INH_, __NOM_, __INH_, __INH_, __NOM_, __INH_,
-	__IDX_, __NOM_, __NOM_, __IDX_, __IDX_, __NOM_, __IDX_, __IDX_,	// 0x60
-	__IDX_, __IDX_, __IDX_, __NOM_, __IDX_, __IDX_, __IDX_, __IDX_,
-	__EXT_, __NOM_, __NOM_, __EXT_, __EXT_, __NOM_, __EXT_, __EXT_,	// 0x70
-	__EXT_, __EXT_, __EXT_, __NOM_, __EXT_, __EXT_, __EXT_, __EXT_,
-	__IMB_, __IMB_, __IMB_, __IMW_, __IMB_, __IMB_, __IMB_, __NOM_,	// 0x80
-	__IMB_, __IMB_, __IMB_, __IMB_, __IMW_, __REB_, __IMW_, __NOM_,
-	__DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_,	// 0x90
-	__DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_,
-	__IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_,	// 0xa0
-	__IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_,
-	__EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_,	// 0xb0
-	__EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_,
-	__IMB_, __IMB_, __IMB_, __IMW_, __IMB_, __IMB_, __IMB_, __NOM_,	// 0xc0
-	__IMB_, __IMB_, __IMB_, __IMB_, __IMW_, __NOM_, __IMW_, __NOM_,
-	__DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_,	// 0xd0
-	__DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_, __DIR_,
-	__IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_,	// 0xe0
-	__IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_, __IDX_,
-	__EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_,	// 0xf0
-	__EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_
-};
-
-enum addr_mode_index addr_mode_page_2[256] = {
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x00
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x10
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __REW_, __REW_, __REW_, __REW_, __REW_, __REW_, __REW_,	// 0x20
-	__REW_, __REW_, __REW_, __REW_, __REW_, __REW_, __REW_, __REW_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x30
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __INH_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x40
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x50
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x60
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x70
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __IMW_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x80
-	__NOM_, __NOM_, __NOM_, __NOM_, __IMW_, __NOM_, __IMW_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __DIR_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x90
-	__NOM_, __NOM_, __NOM_, __NOM_, __DIR_, __NOM_, __DIR_, __DIR_,
-	__NOM_, __NOM_, __NOM_, __IDX_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xa0
-	__NOM_, __NOM_, __NOM_, __NOM_, __IDX_, __NOM_, __IDX_, __IDX_,
-	__NOM_, __NOM_, __NOM_, __EXT_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xb0
-	__NOM_, __NOM_, __NOM_, __NOM_, __EXT_, __NOM_, __EXT_, __EXT_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xc0
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __IMW_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xd0
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __DIR_, __DIR_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xe0
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __IDX_, __IDX_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xf0
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __EXT_, __EXT_
-};
-
-enum addr_mode_index addr_mode_page_3[256] = {
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x00
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x10
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x20
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x30
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __INH_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x40
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x50
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x60
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x70
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __IMW_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x80
-	__NOM_, __NOM_, __NOM_, __NOM_, __IMW_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __DIR_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x90
-	__NOM_, __NOM_, __NOM_, __NOM_, __DIR_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __IDX_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xa0
-	__NOM_, __NOM_, __NOM_, __NOM_, __IDX_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __EXT_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xb0
-	__NOM_, __NOM_, __NOM_, __NOM_, __EXT_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xc0
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xd0
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xe0
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0xf0
-	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_
-};
-
 uint16_t mc6809::disassemble_instruction(char *buffer, size_t n, uint16_t address)
 {
 	disassemble_success = true;
@@ -379,21 +102,21 @@ uint16_t mc6809::disassemble_instruction(char *buffer, size_t n, uint16_t addres
 		buffer += snprintf(buffer, n, "%02x", byte);
 		bytes_printed++;
 		mne_buffer += snprintf(mne_buffer, 17, "%s ",
-			mnemonics[opcodes_page_2[byte]]);
-		mode = addr_mode_page_2[byte];
+			opcode_table.mnemonics[1][byte]);
+		mode = opcode_table.operands[1][byte];
 	} else if (byte == 0x11) {
 		// page 3
 		byte = read8(address++);
 		buffer += snprintf(buffer, n, "%02x", byte);
 		bytes_printed++;
 		mne_buffer += snprintf(mne_buffer, 17, "%s ",
-			mnemonics[opcodes_page_3[byte]]);
-		mode = addr_mode_page_3[byte];
+			opcode_table.mnemonics[2][byte]);
+		mode = opcode_table.operands[2][byte];
 	} else {
 		// page "1"
 		mne_buffer += snprintf(mne_buffer, 17, "%s ",
-			mnemonics[opcodes_page_1[byte]]);
-		mode = addr_mode_page_1[byte];
+			opcode_table.mnemonics[0][byte]);
+		mode = opcode_table.operands[0][byte];
 	}
 
 	if (mode == __NOM_) disassemble_success = false;
@@ -793,3 +516,19 @@ uint16_t mc6809::disassemble_instruction(char *buffer, size_t n, uint16_t addres
 
 	return address - start_address;
 }
+
+/*
+ * Mnemonic of an opcode on page 1, 2 ($10 prefix) or 3 ($11 prefix),
+ * padded with spaces to five characters.
+ */
+const char *mc6809::opcode_mnemonic(int page, uint8_t opcode)
+{
+	switch (page) {
+	case 2:
+		return opcode_table.mnemonics[1][opcode];
+	case 3:
+		return opcode_table.mnemonics[2][opcode];
+	default:
+		return opcode_table.mnemonics[0][opcode];
+	}
+}
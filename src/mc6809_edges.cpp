@@ -0,0 +1,37 @@
+/*
+ * mc6809_edges.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * AFL style edge coverage for fuzzing
+ */
+
+#include "mc6809.hpp"
+#include <cstring>
+
+void mc6809::enable_edge_coverage(bool enable, uint8_t *map)
+{
+	if (enable) {
+		if (map && (map != edge_map)) {
+			if (edge_map_owned) delete [] edge_map;
+			edge_map = map;
+			edge_map_owned = false;
+		} else if (edge_map == NULL) {
+			edge_map = new uint8_t[EDGE_MAP_SIZE]();
+			edge_map_owned = true;
+		}
+		edge_previous = 0;
+		instruments |= INSTRUMENT_EDGES;
+	} else {
+		instruments &= ~INSTRUMENT_EDGES;
+	}
+}
+
+/*
+ * Called before each run of a fuzz input
+ */
+void mc6809::reset_edge_coverage()
+{
+	if (edge_map) memset(edge_map, 0, EDGE_MAP_SIZE);
+	edge_previous = 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * mc6809_heatmap.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Memory access heatmap and bus accesses per opcode
+ */
+
+#include "mc6809.hpp"
+#include <cmath>
+#include <cstring>
+
+void mc6809::enable_heatmap(bool enable)
+{
+	if (enable) {
+		if (heat_reads == NULL) {
+			/*
+			 * One allocation for reads, writes and fetches
+			 */
+			heat_reads = new uint64_t[3 * 65536]();
+			heat_writes = heat_reads + 65536;
+			heat_fetches = heat_writes + 65536;
+			memset(bus_counts, 0, sizeof(bus_counts));
+		}
+		step_reads = 0;
+		step_writes = 0;
+		instruments |= INSTRUMENT_HEATMAP;
+	} else {
+		instruments &= ~INSTRUMENT_HEATMAP;
+	}
+	update_watch_pages();
+}
+
+void mc6809::reset_heatmap()
+{
+	if (heat_reads) {
+		memset(heat_reads, 0, 3 * 65536 * sizeof(uint64_t));
+		memset(bus_counts, 0, sizeof(bus_counts));
+	}
+}
+
+/*
+ * Fetches aren't seen by the bus functions, they're the bytes the
+ * instruction consumed with fetch8(), opcode and page included. All
+ * operands are fetched that way, so every bus read is a read.
+ */
+void mc6809::heatmap_step(bool interrupted)
+{
+	struct bus_counts *counts;
+
+	if (interrupted) {
+		counts = &bus_counts[3][0];
+	} else if (fetched_bytes == 0) {
+		/*
+		 * hle hook, no instruction ran. Its accesses are only in
+		 * the per address counts.
+		 */
+		step_reads = 0;
+		step_writes = 0;
+		return;
+	} else {
+		for (int i=0; i<fetched_bytes; i++) {
+			heat_fetches[(uint16_t)(instruction_pc + i)]++;
+		}
+
+		uint8_t opcode = fetched[0];
+		int page = 0;
+		if ((opcode == 0x10) || (opcode == 0x11)) {
+			page = opcode - 0x0f;
+			opcode = fetched[1];
+		}
+		counts = &bus_counts[page][opcode];
+	}
+
+	counts->executions++;
+	counts->fetches += fetched_bytes;
+	counts->reads += step_reads;
+	counts->writes += step_writes;
+	step_reads = 0;
+	step_writes = 0;
+}
+
+uint64_t mc6809::get_heat(uint16_t address, uint8_t type)
+{
+	if (heat_reads == NULL) return 0;
+
+	uint64_t heat = 0;
+	if (type & HEAT_READ) heat += heat_reads[address];
+	if (type & HEAT_WRITE) heat += heat_writes[address];
+	if (type & HEAT_FETCH) heat += heat_fetches[address];
+	return heat;
+}
+
+uint64_t mc6809::get_page_heat(uint8_t page, uint8_t type)
+{
+	uint64_t heat = 0;
+	for (int i=0; i<256; i++) {
+		heat += get_heat((page << 8) | i, type);
+	}
+	return heat;
+}
+
+/*
+ * Binary greymap, 256x256, logarithmic scale so rarely touched
+ * addresses still show up.
+ */
+void mc6809::heatmap_pgm(FILE *f, uint8_t type)
+{
+	uint64_t max = 0;
+	for (int i=0; i<65536; i++) {
+		uint64_t heat = get_heat(i, type);
+		if (heat > max) max = heat;
+	}
+
+	fprintf(f, "P5\n256 256\n255\n");
+	double scale = max ? 255.0 / log2(1.0 + max) : 0.0;
+	for (int i=0; i<65536; i++) {
+		fputc((int)(log2(1.0 + get_heat(i, type)) * scale + 0.5), f);
+	}
+}
+
+void mc6809::heatmap_csv(FILE *f, uint8_t type)
+{
+	for (int page=0; page<256; page++) {
+		for (int i=0; i<256; i++) {
+			fprintf(f, "%s%llu", i ? "," : "",
+				(unsigned long long)get_heat((page << 8) | i, type));
+		}
+		fprintf(f, "\n");
+	}
+}
+
+void mc6809::bus_statistics_csv(FILE *f)
+{
+	fprintf(f, "page,opcode,name,executions,fetches,reads,writes,accesses_per_instruction\n");
+	for (int page=0; page<4; page++) {
+		for (int i=0; i<256; i++) {
+			struct bus_counts *c = &bus_counts[page][i];
+			if (c->executions == 0) continue;
+			if (page == 3) {
+				fprintf(f, "0,,\"interrupt\",");
+			} else {
+				const char *m = opcode_mnemonic(page + 1, i);
+				fprintf(f, "%i,$%02x,\"%.*s\",", page + 1, i,
+					(int)strcspn(m, " "), m);
+			}
+			fprintf(f, "%llu,%llu,%llu,%llu,%.2f\n",
+				(unsigned long long)c->executions,
+				(unsigned long long)c->fetches,
+				(unsigned long long)c->reads,
+				(unsigned long long)c->writes,
+				(double)(c->fetches + c->reads + c->writes) / c->executions);
+		}
+	}
+}
@@ -0,0 +1,80 @@
+/*
+ * mc6809_hle.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * High level emulation (HLE) hooks. Well known guest routines (block
+ * copy, multiply/divide, print string, ...) can be replaced by native
+ * host functions.
+ */
+
+#include "mc6809.hpp"
+
+void mc6809::register_hle_hook(uint16_t address, hle_function function,
+			       uint16_t hook_cycles, void *data)
+{
+	if (hle_bitmap == NULL) {
+		hle_bitmap = new uint8_t[8192]();
+	}
+
+	for (size_t i=0; i<hle_hooks.size(); i++) {
+		if (hle_hooks[i].address == address) {
+			hle_hooks[i].function = function;
+			hle_hooks[i].data = data;
+			hle_hooks[i].cycles = hook_cycles;
+			return;
+		}
+	}
+
+	hle_hooks.push_back({ address, function, data, hook_cycles });
+	hle_bitmap[address >> 3] |= (1 << (address & 0b111));
+}
+
+void mc6809::unregister_hle_hook(uint16_t address)
+{
+	for (size_t i=0; i<hle_hooks.size(); i++) {
+		if (hle_hooks[i].address == address) {
+			hle_hooks.erase(hle_hooks.begin() + i);
+			hle_bitmap[address >> 3] &= ~(1 << (address & 0b111));
+			return;
+		}
+	}
+}
+
+void mc6809::clear_hle_hooks()
+{
+	hle_hooks.clear();
+	if (hle_bitmap) {
+		for (int i=0; i<8192; i++) {
+			hle_bitmap[i] = 0;
+		}
+	}
+}
+
+/*
+ * Called from execute() when pc is hooked. Returns true when the host
+ * function handled the routine, in that case an rts has been done and
+ * the cycles are accounted for.
+ */
+bool mc6809::run_hle_hook()
+{
+	for (size_t i=0; i<hle_hooks.size(); i++) {
+		if (hle_hooks[i].address == pc) {
+			struct hle_hook hook = hle_hooks[i];
+			if (!hook.function(this, hook.data)) {
+				return false;
+			}
+
+			/*
+			 * rts equivalent
+			 */
+			uint16_t word = pull_sp() << 8;
+			word |= pull_sp();
+			pc = word;
+
+			cycles += hook.cycles;
+			return true;
+		}
+	}
+	return false;
+}
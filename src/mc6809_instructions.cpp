@@ -7,21 +7,32 @@
 #include "mc6809.hpp"
 #include <cstdio>
 
-uint8_t  byte;
-uint16_t word;
-uint32_t dword;
+static uint8_t  byte;
+static uint16_t word;
 
 /*
  * d_reg is a stand-in temporary variable to ease calculations
  * during individual instructions that deal with the d register
  */
-uint16_t d_reg;
+static uint16_t d_reg;
 
+/*
+ * Illegal opcode or illegal indexed postbyte on any of the three pages.
+ * Either start the exception (from 6309) or stop the cpu right away
+ * with pc pointing to the offending instruction.
+ */
 void mc6809::ill(uint16_t ea)
 {
-	// TODO !!!!!
-	// "NEW": from 6309
-	// push all registers, load vector illegal opcode ....
+	if (illegal_opcode_mode == ILLEGAL_OPCODE_STOP) {
+		pc = instruction_pc;
+		cpu_state = CPU_STOPPED;
+		stop_reason = STOP_ILLEGAL_OPCODE;
+		if (illegal_callback) {
+			illegal_callback(this, instruction_pc, illegal_callback_data);
+		}
+	} else {
+		illegal_opcode();
+	}
 }
 
 void mc6809::abx(uint16_t ea)
@@ -31,139 +42,36 @@ void mc6809::abx(uint16_t ea)
 
 void mc6809::adca(uint16_t ea)
 {
-	/*
-	 * See: Osborne, A. 1976. An introduction to microcomputers
-	 * Volume I Basic Concepts. SYBEX. pages 4-12 to 4-16.
-	 */
-
-	uint8_t old_carry = (is_c_flag_set() ? 1 : 0);
-
-	byte = read8(ea);
-
-	/*
-	 * Half carry
-	 */
-	if (((ac & 0x0f) + (byte & 0x0f) + old_carry) & 0b00010000) {
-		set_h_flag();
-	} else {
-		clear_h_flag();
-	}
-
-	bool bit_7_carry_in = (((ac & 0x7f) + (byte & 0x7f) + old_carry) & 0x80) ? true : false;
-
-	word = ac + byte + old_carry;
-	ac = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	if (carry) set_c_flag(); else clear_c_flag();
-	test_nz_flags(ac);
+	ac = add8(ac, bus_read8(ea), is_c_flag_set() ? 1 : 0);
 }
 
 void mc6809::adcb(uint16_t ea)
 {
-	uint8_t old_carry = (is_c_flag_set() ? 1 : 0);
-
-	byte = read8(ea);
-
-	/*
-	 * Half carry
-	 */
-	if (((br & 0x0f) + (byte & 0x0f) + old_carry) & 0b00010000) {
-		set_h_flag();
-	} else {
-		clear_h_flag();
-	}
-
-	bool bit_7_carry_in = (((br & 0x7f) + (byte & 0x7f) + old_carry) & 0x80) ? true : false;
-
-	word = br + byte + old_carry;
-	br = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	if (carry) set_c_flag(); else clear_c_flag();
-	test_nz_flags(br);
+	br = add8(br, bus_read8(ea), is_c_flag_set() ? 1 : 0);
 }
 
 void mc6809::adda(uint16_t ea)
 {
-	byte = read8(ea);
-
-	/*
-	 * Half carry
-	 */
-	if (((ac & 0x0f) + (byte & 0x0f)) & 0b00010000) {
-		set_h_flag();
-	} else {
-		clear_h_flag();
-	}
-
-	bool bit_7_carry_in = (((ac & 0x7f) + (byte & 0x7f)) & 0x80) ? true : false;
-
-	word = ac + byte;
-	ac = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	if (carry) set_c_flag(); else clear_c_flag();
-	test_nz_flags(ac);
+	ac = add8(ac, bus_read8(ea), 0);
 }
 
 void mc6809::addb(uint16_t ea)
 {
-	byte = read8(ea);
-
-	/*
-	 * Half carry
-	 */
-	if (((br & 0x0f) + (byte & 0x0f)) & 0b00010000) {
-		set_h_flag();
-	} else {
-		clear_h_flag();
-	}
-
-	bool bit_7_carry_in = (((br & 0x7f) + (byte & 0x7f)) & 0x80) ? true : false;
-
-	word = br + byte;
-	br = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	if (carry) set_c_flag(); else clear_c_flag();
-	test_nz_flags(br);
+	br = add8(br, bus_read8(ea), 0);
 }
 
 void mc6809::addd(uint16_t ea)
 {
-	word = (read8(ea++)) << 8;
-	word |= read8(ea);
-
-	d_reg = (ac << 8) | br;
-
-	/* no need for half-carry here */
-
-	bool bit_15_carry_in = (((d_reg & 0x7fff) + (word & 0x7fff)) & 0x8000) ? true : false;
-
-	dword = d_reg + word;
-	d_reg = dword & 0xffff;
-	ac = (d_reg & 0xff00) >> 8;
+	word = bus_read8(ea++) << 8;
+	word |= bus_read8(ea);
+	d_reg = add16((ac << 8) | br, word);
+	ac = d_reg >> 8;
 	br = d_reg & 0xff;
-
-	bool carry = (dword & 0x00010000) ? true : false;
-
-	if(carry != bit_15_carry_in) set_v_flag(); else clear_v_flag();
-	if(carry) set_c_flag(); else clear_c_flag();
-	test_nz_flags_16(d_reg);
 }
 
 void mc6809::anda(uint16_t ea)
 {
-	byte = ac & read8(ea);
+	byte = ac & bus_read8(ea);
 	clear_v_flag();
 	test_nz_flags(byte);
 	ac = byte;
@@ -171,7 +79,7 @@ void mc6809::anda(uint16_t ea)
 
 void mc6809::andb(uint16_t ea)
 {
-	byte = br & read8(ea);
+	byte = br & bus_read8(ea);
 	clear_v_flag();
 	test_nz_flags(byte);
 	br = byte;
@@ -179,12 +87,12 @@ void mc6809::andb(uint16_t ea)
 
 void mc6809::andcc(uint16_t ea)
 {
-	cc &= read8(ea);
+	cc &= fetch8();
 }
 
 void mc6809::asl(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = bus_read8(ea);
 
 	if (byte & 0x80) set_c_flag(); else clear_c_flag();
 	if (((byte & 0xc0) == 0x80) || ((byte & 0xc0) == 0x40))
@@ -193,7 +101,7 @@ void mc6809::asl(uint16_t ea)
 	byte <<= 1;
 
 	test_nz_flags(byte);
-	write8(ea, byte);
+	bus_write8(ea, byte);
 }
 
 void mc6809::asla(uint16_t ea)
@@ -220,7 +128,7 @@ void mc6809::aslb(uint16_t ea)
 
 void mc6809::asr(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = bus_read8(ea);
 
 	if (byte & 0x01) set_c_flag(); else clear_c_flag();
 	bool bit7 = (byte & 0x80) ? true : false;
@@ -229,7 +137,7 @@ void mc6809::asr(uint16_t ea)
 	if (bit7) byte |= 0x80; else byte &= 0x7f;
 
 	test_nz_flags(byte);
-	write8(ea, byte);
+	bus_write8(ea, byte);
 }
 
 void mc6809::asra(uint16_t ea)
@@ -254,129 +162,76 @@ void mc6809::asrb(uint16_t ea)
 	test_nz_flags(br);
 }
 
-void mc6809::beq(uint16_t ea)
-{
-	if (is_z_flag_set()) pc = ea;
-}
-
-void mc6809::bge(uint16_t ea)
-{
-	// both n and v set  OR  both n and v clear
-	if ((is_n_flag_set() && is_v_flag_set()) || (is_n_flag_clear() && is_v_flag_clear())) {
-		pc = ea;
-	}
-}
-
-void mc6809::bgt(uint16_t ea)
-{
-	// (both n and v set  OR  both n and v clear)  AND  (z clear)
-	if (((is_n_flag_set() && is_v_flag_set()) || (is_n_flag_clear() && is_v_flag_clear())) && is_z_flag_clear()) {
-		pc = ea;
-	}
-}
-
-void mc6809::bhi(uint16_t ea)
-{
-	if (is_z_flag_clear() && is_c_flag_clear()) {
-		pc = ea;
-	}
-}
-
-/*
- * bhs - Branch if Higher or Same
- * bcc - Branch if Carry Clear
- *
- * E.g. if no borrow was needed (carry clear) after a comparison, then
- * value in register must be higher than or the same as the compared value.
- */
-void mc6809::bhs(uint16_t ea)
-{
-	if (is_c_flag_clear()) {
-		pc = ea;
-	}
-}
-
 void mc6809::bita(uint16_t ea)
 {
-	byte = ac & read8(ea);
+	byte = ac & bus_read8(ea);
 	clear_v_flag();
 	test_nz_flags(byte);
 }
 
 void mc6809::bitb(uint16_t ea)
 {
-	byte = br & read8(ea);
+	byte = br & bus_read8(ea);
 	clear_v_flag();
 	test_nz_flags(byte);
 }
 
-void mc6809::ble(uint16_t ea)
-{
-	if (is_z_flag_set() || (is_n_flag_set() && is_v_flag_clear()) || (is_n_flag_clear() && is_v_flag_set())) {
-		pc = ea;
-	}
-}
-
 /*
- * blo - Branch if Lower
- * bcs - Branch if Carry Set
- *
- * E.g. if a borrow was needed (carry set) after a comparison, the
- * value in the register must be lower than the compared value.
+ * Generated at compile time from the flag equations of the 16 branch
+ * conditions, see struct branch_conditions.
  */
-void mc6809::blo(uint16_t ea)
-{
-	if (is_c_flag_set()) {
-		pc = ea;
-	}
-}
-
-/*
- * bls - Branch if Lower or Same
- */
-void mc6809::bls(uint16_t ea)
-{
-	if (is_c_flag_set() || is_z_flag_set()) {
-		pc = ea;
-	}
-}
-
-void mc6809::blt(uint16_t ea)
-{
-	if ((is_n_flag_set() && is_v_flag_clear()) || (is_n_flag_clear() && is_v_flag_set())) {
-		pc = ea;
+constexpr uint16_t mc6809::decode_branch_conditions(uint8_t cc)
+{
+	bool c = cc & C_FLAG;
+	bool v = cc & V_FLAG;
+	bool z = cc & Z_FLAG;
+	bool n = cc & N_FLAG;
+
+	bool taken[16] = {
+		true,			// bra
+		false,			// brn
+		!(c || z),		// bhi
+		c || z,			// bls
+		!c,			// bhs / bcc
+		c,			// blo / bcs
+		!z,			// bne
+		z,			// beq
+		!v,			// bvc
+		v,			// bvs
+		!n,			// bpl
+		n,			// bmi
+		n == v,			// bge
+		n != v,			// blt
+		!z && (n == v),		// bgt
+		z || (n != v)		// ble
+	};
+
+	uint16_t conditions = 0;
+	for (int i = 0; i < 16; i++) {
+		if (taken[i]) conditions |= 1 << i;
 	}
+	return conditions;
 }
 
-void mc6809::bmi(uint16_t ea)
+constexpr struct mc6809::branch_conditions mc6809::generate_branch_conditions()
 {
-	if (is_n_flag_set()) {
-		pc = ea;
-	}
-}
+	struct branch_conditions table = {};
 
-void mc6809::bne(uint16_t ea)
-{
-	if (is_z_flag_clear()) {
-		pc = ea;
+	for (int cc = 0; cc < 256; cc++) {
+		table.taken[cc] = decode_branch_conditions(cc);
 	}
+	return table;
 }
 
-void mc6809::bpl(uint16_t ea)
-{
-	if (is_n_flag_clear()) {
-		pc = ea;
-	}
-}
-
-void mc6809::bra(uint16_t ea)
-{
-	pc = ea;
-}
+constexpr struct mc6809::branch_conditions mc6809::branch_table = mc6809::generate_branch_conditions();
 
-void mc6809::brn(uint16_t ea)
+/*
+ * All short branches, bra ($20) to ble ($2f). The condition is the low
+ * nibble of the opcode.
+ */
+void mc6809::branch(uint16_t ea)
 {
-	// does essentially nothing
+	if (branch_table.taken[cc] & (1 << (opcode & 0x0f))) pc = ea;
 }
 
 void mc6809::bsr(uint16_t ea)
@@ -386,23 +241,9 @@ void mc6809::bsr(uint16_t ea)
 	pc = ea;
 }
 
-void mc6809::bvc(uint16_t ea)
-{
-	if (is_v_flag_clear()) {
-		pc = ea;
-	}
-}
-
-void mc6809::bvs(uint16_t ea)
-{
-	if (is_v_flag_set()) {
-		pc = ea;
-	}
-}
-
 void mc6809::clr(uint16_t ea)
 {
-	write8(ea, 0x00);
+	bus_write8(ea, 0x00);
 	clear_n_flag();
 	set_z_flag();
 	clear_v_flag();
@@ -429,113 +270,54 @@ void mc6809::clrb(uint16_t ea)
 
 void mc6809::cmpa(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	byte = read8(ea);
-	word = ac - byte;
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((ac ^ word) & 0x80) && ((ac ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
-	byte = word & 0xff;
-	test_nz_flags(byte);
+	sub8(ac, bus_read8(ea), 0);
 }
 
 void mc6809::cmpb(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	byte = read8(ea);
-	word = br - byte;
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((br ^ word) & 0x80) && ((br ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
-	byte = word & 0xff;
-	test_nz_flags(byte);
+	sub8(br, bus_read8(ea), 0);
 }
 
 void mc6809::cmpd(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	word = read8(ea++) << 8;
-	word |= read8((uint16_t)ea);
-	d_reg = (ac << 8) | br;
-	dword = d_reg - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((d_reg ^ dword) & 0x8000) && ((d_reg ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	word = dword & 0xffff;
-	test_nz_flags_16(word);
+	word = bus_read8(ea++) << 8;
+	word |= bus_read8(ea);
+	sub16((ac << 8) | br, word);
 }
 
 void mc6809::cmpu(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	word = read8(ea++) << 8;
-	word |= read8((uint16_t)ea);
-	dword = us - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((us ^ dword) & 0x8000) && ((us ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	word = dword & 0xffff;
-	test_nz_flags_16(word);
+	word = bus_read8(ea++) << 8;
+	word |= bus_read8(ea);
+	sub16(us, word);
 }
 
 void mc6809::cmps(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	word = read8(ea++) << 8;
-	word |= read8((uint16_t)ea);
-	dword = sp - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((sp ^ dword) & 0x8000) && ((sp ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	word = dword & 0xffff;
-	test_nz_flags_16(word);
+	word = bus_read8(ea++) << 8;
+	word |= bus_read8(ea);
+	sub16(sp, word);
 }
 
 void mc6809::cmpx(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	word = read8(ea++) << 8;
-	word |= read8((uint16_t)ea);
-	dword = xr - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((xr ^ dword) & 0x8000) && ((xr ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	word = dword & 0xffff;
-	test_nz_flags_16(word);
+	word = bus_read8(ea++) << 8;
+	word |= bus_read8(ea);
+	sub16(xr, word);
 }
 
 void mc6809::cmpy(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	word = read8(ea++) << 8;
-	word |= read8((uint16_t)ea);
-	dword = yr - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((yr ^ dword) & 0x8000) && ((yr ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	word = dword & 0xffff;
-	test_nz_flags_16(word);
+	word = bus_read8(ea++) << 8;
+	word |= bus_read8(ea);
+	sub16(yr, word);
 }
 
 void mc6809::com(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = bus_read8(ea);
 	byte = ~byte;
-	write8(ea, byte);
+	bus_write8(ea, byte);
 	test_nz_flags(byte);
 	clear_v_flag();
 	set_c_flag();
@@ -559,7 +341,8 @@ void mc6809::comb(uint16_t ea)
 
 void mc6809::cwai(uint16_t ea)
 {
-	//
+	// mask byte is fetched, cwai itself isn't implemented yet
+	fetch8();
 }
 
 void mc6809::daa(uint16_t ea)
@@ -571,13 +354,17 @@ void mc6809::daa(uint16_t ea)
 		byte |= 0x60;
 	word = ac + byte;
 	ac = word & 0xff;
-	if (word & 0x0100) set_c_flag(); else clear_c_flag();
+	/*
+	 * Carry is set by the correction, but never cleared: a carry out
+	 * of the preceding addition must survive the adjust.
+	 */
+	if (word & 0x0100) set_c_flag();
 	test_nz_flags(ac);
 }
 
 void mc6809::dec(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = bus_read8(ea);
 
 	bool bit_7_carry_in = (((byte & 0x7f) + 0x7f) & 0x80) ? true : false;
 
@@ -589,7 +376,7 @@ void mc6809::dec(uint16_t ea)
 	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
 	test_nz_flags(byte);
 
-	write8(ea, byte);
+	bus_write8(ea, byte);
 }
 
 void mc6809::deca(uint16_t ea)
@@ -620,14 +407,14 @@ void mc6809::decb(uint16_t ea)
 
 void mc6809::eora(uint16_t ea)
 {
-	ac ^= read8(ea);
+	ac ^= bus_read8(ea);
 	clear_v_flag();
 	test_nz_flags(ac);
 }
 
 void mc6809::eorb(uint16_t ea)
 {
-	br ^= read8(ea);
+	br ^= bus_read8(ea);
 	clear_v_flag();
 	test_nz_flags(br);
 }
@@ -638,7 +425,7 @@ void mc6809::exg(uint16_t ea)
 
 	/* when the sp is written to, it enables nmi's */
 
-	switch (read8(ea)) {
+	switch (fetch8()) {
 		/*
 		 * exchange 16 bit registers
 		 */
@@ -715,7 +502,7 @@ void mc6809::exg(uint16_t ea)
 
 void mc6809::inc(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = bus_read8(ea);
 
 	bool bit_7_carry_in = (((byte & 0x7f) + 0x01) & 0x80) ? true : false;
 
@@ -727,7 +514,7 @@ void mc6809::inc(uint16_t ea)
 	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
 	test_nz_flags(byte);
 
-	write8(ea, byte);
+	bus_write8(ea, byte);
 }
 
 void mc6809::inca(uint16_t ea)
@@ -768,131 +555,11 @@ void mc6809::jsr(uint16_t ea)
 	pc = ea;
 }
 
-void mc6809::lbeq(uint16_t ea)
-{
-	if (is_z_flag_set()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-void mc6809::lbge(uint16_t ea)
-{
-	// both n and v set  OR  both n and v clear
-	if ((is_n_flag_set() && is_v_flag_set()) || (is_n_flag_clear() && is_v_flag_clear())) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-void mc6809::lbgt(uint16_t ea)
-{
-	// (both n and v set  OR  both n and v clear)  AND  (z clear)
-	if (((is_n_flag_set() && is_v_flag_set()) || (is_n_flag_clear() && is_v_flag_clear())) && is_z_flag_clear()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-void mc6809::lbhi(uint16_t ea)
-{
-	if (is_z_flag_clear() && is_c_flag_clear()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-/*
- * lbhs - Branch if Higher or Same
- * lbcc - Branch if Carry Clear
- *
- * E.g. if no borrow was needed (carry clear) after a comparison, then
- * value in register must be higher or the same as the compared value.
- */
-void mc6809::lbhs(uint16_t ea)
-{
-	if (is_c_flag_clear()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-void mc6809::lble(uint16_t ea)
-{
-	if (is_z_flag_set() || (is_n_flag_set() && is_v_flag_clear()) || (is_n_flag_clear() && is_v_flag_set())) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-/*
- * lblo - Branch if Lower
- * lbcs - Branch if Carry Set
- *
- * E.g. if a borrow was needed (carry set) after a comparison, the
- * value in the register must be lower than the compared value.
- */
-void mc6809::lblo(uint16_t ea)
-{
-	if (is_c_flag_set()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-/*
- * bls - Branch if Lower or Same
- */
-void mc6809::lbls(uint16_t ea)
-{
-	if (is_c_flag_set() || is_z_flag_set()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-void mc6809::lblt(uint16_t ea)
-{
-	if ((is_n_flag_set() && is_v_flag_clear()) || (is_n_flag_clear() && is_v_flag_set())) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-void mc6809::lbmi(uint16_t ea)
-{
-	if (is_n_flag_set()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-void mc6809::lbne(uint16_t ea)
-{
-	if (is_z_flag_clear()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-void mc6809::lbpl(uint16_t ea)
-{
-	if (is_n_flag_clear()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
 void mc6809::lbra(uint16_t ea)
 {
 	pc = ea;
 }
 
-void mc6809::lbrn(uint16_t ea)
-{
-	// does essentially nothing
-}
-
 void mc6809::lbsr(uint16_t ea)
 {
 	push_sp(pc & 0x00ff);
@@ -900,40 +567,24 @@ void mc6809::lbsr(uint16_t ea)
 	pc = ea;
 }
 
-void mc6809::lbvc(uint16_t ea)
-{
-	if (is_v_flag_clear()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
-void mc6809::lbvs(uint16_t ea)
-{
-	if (is_v_flag_set()) {
-		pc = ea;
-		cycles += 1;
-	}
-}
-
 void mc6809::lda(uint16_t ea)
 {
-	ac = read8(ea);
+	ac = bus_read8(ea);
 	clear_v_flag();
 	test_nz_flags(ac);
 }
 
 void mc6809::ldb(uint16_t ea)
 {
-	br = read8(ea);
+	br = bus_read8(ea);
 	clear_v_flag();
 	test_nz_flags(br);
 }
 
 void mc6809::ldd(uint16_t ea)
 {
-	ac = read8(ea++);
-	br = read8((uint16_t)ea);
+	ac = bus_read8(ea++);
+	br = bus_read8((uint16_t)ea);
 	d_reg = (ac << 8) | br;
 	clear_v_flag();
 	test_nz_flags_16(d_reg);
@@ -941,8 +592,8 @@ void mc6809::ldd(uint16_t ea)
 
 void mc6809::lds(uint16_t ea)
 {
-	sp = read8(ea++) << 8;
-	sp |= read8((uint16_t)ea);
+	sp = bus_read8(ea++) << 8;
+	sp |= bus_read8((uint16_t)ea);
 	clear_v_flag();
 	test_nz_flags_16(sp);
 
@@ -952,24 +603,24 @@ void mc6809::lds(uint16_t ea)
 
 void mc6809::ldu(uint16_t ea)
 {
-	us = read8(ea++) << 8;
-	us |= read8((uint16_t)ea);
+	us = bus_read8(ea++) << 8;
+	us |= bus_read8((uint16_t)ea);
 	clear_v_flag();
 	test_nz_flags_16(us);
 }
 
 void mc6809::ldx(uint16_t ea)
 {
-	xr = read8(ea++) << 8;
-	xr |= read8((uint16_t)ea);
+	xr = bus_read8(ea++) << 8;
+	xr |= bus_read8((uint16_t)ea);
 	clear_v_flag();
 	test_nz_flags_16(xr);
 }
 
 void mc6809::ldy(uint16_t ea)
 {
-	yr = read8(ea++) << 8;
-	yr |= read8((uint16_t)ea);
+	yr = bus_read8(ea++) << 8;
+	yr |= bus_read8((uint16_t)ea);
 	clear_v_flag();
 	test_nz_flags_16(yr);
 }
@@ -1001,14 +652,26 @@ void mc6809::leau(uint16_t ea)
 	us = ea;
 }
 
+/*
+ * All long conditional branches, lbrn ($10 $21) to lble ($10 $2f). A
+ * taken branch costs one extra cycle.
+ */
+void mc6809::long_branch(uint16_t ea)
+{
+	if (branch_table.taken[cc] & (1 << (opcode & 0x0f))) {
+		pc = ea;
+		cycles += 1;
+	}
+}
+
 void mc6809::lsr(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = bus_read8(ea);
 	if (byte & 0x01) set_c_flag(); else clear_c_flag();
 	byte >>= 1;
 	test_z_flag(byte);
 	clear_n_flag();
-	write8(ea, byte);
+	bus_write8(ea, byte);
 }
 
 void mc6809::lsra(uint16_t ea)
@@ -1038,13 +701,13 @@ void mc6809::mul(uint16_t ea)
 
 void mc6809::neg(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = bus_read8(ea);
 	if (byte == 0x80) set_v_flag(); else clear_v_flag();
 	if (byte == 0x00) clear_c_flag(); else set_c_flag();
 	byte = ~byte;
 	byte++;
 	test_nz_flags(byte);
-	write8(ea, byte);
+	bus_write8(ea, byte);
 }
 
 void mc6809::nega(uint16_t ea)
@@ -1072,7 +735,7 @@ void mc6809::nop(uint16_t ea)
 
 void mc6809::ora(uint16_t ea)
 {
-	byte = ac | read8(ea);
+	byte = ac | bus_read8(ea);
 	clear_v_flag();
 	test_nz_flags(byte);
 	ac = byte;
@@ -1080,7 +743,7 @@ void mc6809::ora(uint16_t ea)
 
 void mc6809::orb(uint16_t ea)
 {
-	byte = br | read8(ea);
+	byte = br | bus_read8(ea);
 	clear_v_flag();
 	test_nz_flags(byte);
 	br = byte;
@@ -1088,34 +751,26 @@ void mc6809::orb(uint16_t ea)
 
 void mc6809::orcc(uint16_t ea)
 {
-	cc |= read8(ea);
+	cc |= fetch8();
 }
 
 void mc6809::page2(uint16_t ea)
 {
-	uint8_t opcode = read8(pc++);
-	cycles += cycles_page2[opcode];
-
-	bool am_legal;
-
-	uint16_t effective_address = (this->*addressing_modes_page2[opcode])(&am_legal);
-	(this->*opcodes_page2[opcode])(effective_address);
+	opcode = fetch8();
+	cycles += opcode_table.cycles[1][opcode];
+	(this->*opcode_table.execute[1][opcode])();
 }
 
 void mc6809::page3(uint16_t ea)
 {
-	uint8_t opcode = read8(pc++);
-	cycles += cycles_page3[opcode];
-
-	bool am_legal;
-
-	uint16_t effective_address = (this->*addressing_modes_page3[opcode])(&am_legal);
-	(this->*opcodes_page3[opcode])(effective_address);
+	opcode = fetch8();
+	cycles += opcode_table.cycles[2][opcode];
+	(this->*opcode_table.execute[2][opcode])();
 }
 
 void mc6809::pshs(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = fetch8();
 
 	if (byte & 0x80) { push_sp(pc & 0x00ff); push_sp((pc & 0xff00) >> 8); cycles += 2; }
 	if (byte & 0x40) { push_sp(us & 0x00ff); push_sp((us & 0xff00) >> 8); cycles += 2; }
@@ -1129,7 +784,7 @@ void mc6809::pshs(uint16_t ea)
 
 void mc6809::pshu(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = fetch8();
 
 	if (byte & 0x80) { push_us(pc & 0x00ff); push_us((pc & 0xff00) >> 8); cycles += 2; }
 	if (byte & 0x40) { push_us(sp & 0x00ff); push_us((sp & 0xff00) >> 8); cycles += 2; }
@@ -1143,7 +798,7 @@ void mc6809::pshu(uint16_t ea)
 
 void mc6809::puls(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = fetch8();
 
 	if (byte & 0x01) { cc   = pull_sp();                                    cycles += 1; }
 	if (byte & 0x02) { ac   = pull_sp();                                    cycles += 1; }
@@ -1157,7 +812,7 @@ void mc6809::puls(uint16_t ea)
 
 void mc6809::pulu(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = fetch8();
 
 	if (byte & 0x01) { cc   = pull_us();                                    cycles += 1; }
 	if (byte & 0x02) { ac   = pull_us();                                    cycles += 1; }
@@ -1171,7 +826,7 @@ void mc6809::pulu(uint16_t ea)
 
 void mc6809::rol(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = bus_read8(ea);
 	uint8_t old_carry = cc & C_FLAG;
 	if (((byte & 0b11000000) == 0b01000000) || ((byte & 0b11000000) == 0b10000000))
 		set_v_flag(); else clear_v_flag();
@@ -1179,7 +834,7 @@ void mc6809::rol(uint16_t ea)
 	byte <<= 1;
 	byte |= old_carry;
 	test_nz_flags(byte);
-	write8(ea, byte);
+	bus_write8(ea, byte);
 }
 
 void mc6809::rola(uint16_t ea)
@@ -1206,13 +861,13 @@ void mc6809::rolb(uint16_t ea)
 
 void mc6809::ror(uint16_t ea)
 {
-	byte = read8(ea);
+	byte = bus_read8(ea);
 	bool old_carry = is_c_flag_set();
 	if (byte & 0x01) set_c_flag(); else clear_c_flag();
 	byte >>= 1;
 	if (old_carry) byte |= 0x80;
 	test_nz_flags(byte);
-	write8(ea, byte);
+	bus_write8(ea, byte);
 }
 
 void mc6809::rora(uint16_t ea)
@@ -1266,30 +921,12 @@ void mc6809::rts(uint16_t ea)
 
 void mc6809::sbca(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	byte = read8(ea);
-	word = ac - byte - (is_c_flag_set() ? 1 : 0);
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((ac ^ word) & 0x80) && ((ac ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
-	ac = word & 0xff;
-	test_nz_flags(ac);
+	ac = sub8(ac, bus_read8(ea), is_c_flag_set() ? 1 : 0);
 }
 
 void mc6809::sbcb(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	byte = read8(ea);
-	word = br - byte - (is_c_flag_set() ? 1 : 0);
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((br ^ word) & 0x80) && ((br ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
-	br = word & 0xff;
-	test_nz_flags(br);
+	br = sub8(br, bus_read8(ea), is_c_flag_set() ? 1 : 0);
 }
 
 void mc6809::sex(uint16_t ea)
@@ -1300,22 +937,22 @@ void mc6809::sex(uint16_t ea)
 
 void mc6809::sta(uint16_t ea)
 {
-	write8(ea, ac);
+	bus_write8(ea, ac);
 	clear_v_flag();
 	test_nz_flags(ac);
 }
 
 void mc6809::stb(uint16_t ea)
 {
-	write8(ea, br);
+	bus_write8(ea, br);
 	clear_v_flag();
 	test_nz_flags(br);
 }
 
 void mc6809::std(uint16_t ea)
 {
-	write8(ea++, ac);
-	write8(ea, br);
+	bus_write8(ea++, ac);
+	bus_write8(ea, br);
 	d_reg = (ac << 8) | br;
 	clear_v_flag();
 	test_nz_flags_16(d_reg);
@@ -1323,82 +960,53 @@ void mc6809::std(uint16_t ea)
 
 void mc6809::stu(uint16_t ea)
 {
-	write8(ea++, us >> 8);
-	write8(ea, us & 0xff);
+	bus_write8(ea++, us >> 8);
+	bus_write8(ea, us & 0xff);
 	clear_v_flag();
 	test_nz_flags_16(us);
 }
 
 void mc6809::sts(uint16_t ea)
 {
-	write8(ea++, sp >> 8);
-	write8(ea, sp & 0xff);
+	bus_write8(ea++, sp >> 8);
+	bus_write8(ea, sp & 0xff);
 	clear_v_flag();
 	test_nz_flags_16(sp);
 }
 
 void mc6809::stx(uint16_t ea)
 {
-	write8(ea++, xr >> 8);
-	write8(ea, xr & 0xff);
+	bus_write8(ea++, xr >> 8);
+	bus_write8(ea, xr & 0xff);
 	clear_v_flag();
 	test_nz_flags_16(xr);
 }
 
 void mc6809::sty(uint16_t ea)
 {
-	write8(ea++, yr >> 8);
-	write8(ea, yr & 0xff);
+	bus_write8(ea++, yr >> 8);
+	bus_write8(ea, yr & 0xff);
 	clear_v_flag();
 	test_nz_flags_16(yr);
 }
 
 void mc6809::suba(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	byte = read8(ea);
-	word = ac - byte;
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((ac ^ word) & 0x80) && ((ac ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
-	ac = word & 0xff;
-	test_nz_flags(ac);
+	ac = sub8(ac, bus_read8(ea), 0);
 }
 
 void mc6809::subb(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	byte = read8(ea);
-	word = br - byte;
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((br ^ word) & 0x80) && ((br ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
-	br = word & 0xff;
-	test_nz_flags(br);
+	br = sub8(br, bus_read8(ea), 0);
 }
 
 void mc6809::subd(uint16_t ea)
 {
-	/* code inspired by virtualc64 */
-	word = read8(ea++) << 8;
-	word |= read8((uint16_t)ea);
-
-	d_reg = (ac << 8) | br;
-
-	dword = d_reg - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((d_reg ^ dword) & 0x8000) && ((d_reg ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	d_reg = dword & 0xffff;
-	ac = (d_reg & 0xff00) >> 8;
+	word = bus_read8(ea++) << 8;
+	word |= bus_read8(ea);
+	d_reg = sub16((ac << 8) | br, word);
+	ac = d_reg >> 8;
 	br = d_reg & 0xff;
-	test_nz_flags_16(d_reg);
 }
 
 void mc6809::swi(uint16_t ea)
@@ -1419,8 +1027,8 @@ void mc6809::swi(uint16_t ea)
 	set_i_flag();
 	set_f_flag();
 	pc = 0;
-	pc = (read8(VECTOR_SWI)) << 8;
-	pc |= read8(VECTOR_SWI+1);
+	pc = (bus_read8(VECTOR_SWI)) << 8;
+	pc |= bus_read8(VECTOR_SWI+1);
 }
 
 void mc6809::swi2(uint16_t ea)
@@ -1439,12 +1047,22 @@ void mc6809::swi2(uint16_t ea)
 	push_sp(ac);
 	push_sp(cc);
 	pc = 0;
-	pc = (read8(VECTOR_SWI2)) << 8;
-	pc |= read8(VECTOR_SWI2+1);
+	pc = (bus_read8(VECTOR_SWI2)) << 8;
+	pc |= bus_read8(VECTOR_SWI2+1);
 }
 
 void mc6809::swi3(uint16_t ea)
 {
+	if (syscall_gate == SYSCALL_GATE_SWI3) {
+		/*
+		 * No registers are stacked, charge the gate instead of
+		 * the 20 cycles of swi3.
+		 */
+		cycles += SYSCALL_GATE_CYCLES - opcode_table.cycles[2][0x3f];
+		do_syscall(fetch8());
+		return;
+	}
+
 	set_e_flag();
 	push_sp(pc & 0x00ff);
 	push_sp((pc & 0xff00) >> 8);
@@ -1459,8 +1077,8 @@ void mc6809::swi3(uint16_t ea)
 	push_sp(ac);
 	push_sp(cc);
 	pc = 0;
-	pc = (read8(VECTOR_SWI3)) << 8;
-	pc |= read8(VECTOR_SWI3+1);
+	pc = (bus_read8(VECTOR_SWI3)) << 8;
+	pc |= bus_read8(VECTOR_SWI3+1);
 }
 
 void mc6809::sync(uint16_t ea)
@@ -1474,7 +1092,7 @@ void mc6809::tfr(uint16_t ea)
 
 	/* when sp is written to, nmi's are enabled */
 
-	switch (read8(ea)) {
+	switch (fetch8()) {
 		/*
 		 * transfer 16 bit registers
 		 */
@@ -1551,7 +1169,7 @@ void mc6809::tfr(uint16_t ea)
 
 void mc6809::tst(uint16_t ea)
 {
-	test_nz_flags(read8(ea));
+	test_nz_flags(bus_read8(ea));
 	clear_v_flag();
 }
 
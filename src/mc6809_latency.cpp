@@ -0,0 +1,215 @@
+/*
+ * mc6809_latency.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Interrupt latency, service time and masked periods
+ */
+
+#include "mc6809.hpp"
+#include <algorithm>
+#include <cstring>
+
+static const char *source_names[STAT_SWI] = { "nmi", "firq", "irq" };
+
+static void latency_add(struct mc6809_latency_stats *s, uint64_t cycles)
+{
+	if ((s->count == 0) || (cycles < s->min)) s->min = cycles;
+	if (cycles > s->max) s->max = cycles;
+	s->count++;
+	s->total += cycles;
+
+	int bucket = 0;
+	while ((bucket < (LATENCY_BUCKETS - 1)) && (cycles >= (1ULL << bucket))) {
+		bucket++;
+	}
+	s->histogram[bucket]++;
+}
+
+void mc6809::enable_interrupt_latency(bool enable)
+{
+	if (enable) {
+		if (!(instruments & INSTRUMENT_LATENCY)) {
+			/*
+			 * Lines that are already asserted count from now,
+			 * open masked periods start at the current pc.
+			 */
+			for (int i=0; i<STAT_SWI; i++) line_pending[i] = false;
+			mask_start_pc[0] = mask_start_pc[1] = pc;
+			mask_start[0] = mask_start[1] = latency_cycles;
+			service_stack.clear();
+		}
+		instruments |= INSTRUMENT_LATENCY;
+	} else {
+		instruments &= ~INSTRUMENT_LATENCY;
+	}
+}
+
+void mc6809::reset_interrupt_latency()
+{
+	latency_cycles = 0;
+	memset(line_asserted, 0, sizeof(line_asserted));
+	memset(line_pending, 0, sizeof(line_pending));
+	memset(latency, 0, sizeof(latency));
+	memset(service, 0, sizeof(service));
+	service_stack.clear();
+	masked_periods.clear();
+	mask_start_pc[0] = mask_start_pc[1] = pc;
+	mask_start[0] = mask_start[1] = 0;
+}
+
+const struct mc6809_latency_stats &mc6809::get_interrupt_latency(enum statistics_interrupt_t source)
+{
+	return latency[source < STAT_SWI ? source : STAT_IRQ];
+}
+
+const struct mc6809_latency_stats &mc6809::get_interrupt_service(enum statistics_interrupt_t source)
+{
+	return service[source < STAT_SWI ? source : STAT_IRQ];
+}
+
+/*
+ * Called before the interrupt checks. Lines are only looked at between
+ * instructions, so an assertion is seen up to one instruction late.
+ * firq and irq are level triggered, a line that goes high again before
+ * it was serviced is forgotten. nmi is edge triggered and stays pending
+ * until taken.
+ */
+void mc6809::latency_lines()
+{
+	bool asserted[STAT_SWI] = {
+		(*nmi_line == false) && (old_nmi_line == true),
+		*firq_line == false,
+		*irq_line == false
+	};
+
+	for (int i=0; i<STAT_SWI; i++) {
+		if (asserted[i]) {
+			if (!line_pending[i]) {
+				line_pending[i] = true;
+				line_asserted[i] = latency_cycles;
+			}
+		} else if (i != STAT_NMI) {
+			line_pending[i] = false;
+		}
+	}
+}
+
+void mc6809::latency_step(uint16_t consumed, uint8_t old_cc,
+			  enum statistics_interrupt_t interrupt)
+{
+	/*
+	 * Service time ends when sp rises above the frame pushed on entry,
+	 * that's the rti (or anything else unwinding it). Entry and rti
+	 * cycles are both included.
+	 */
+	while (!service_stack.empty() && (sp > service_stack.back().sp)) {
+		struct service_frame &frame = service_stack.back();
+		latency_add(&service[frame.source], latency_cycles + consumed - frame.entry);
+		service_stack.pop_back();
+	}
+
+	if (interrupt < STAT_SWI) {
+		latency_add(&latency[interrupt], latency_cycles - line_asserted[interrupt]);
+		line_pending[interrupt] = false;
+		service_stack.push_back({ interrupt, sp, latency_cycles });
+	}
+
+	/*
+	 * A masked period starts at the instruction that set the flag (or
+	 * at the handler, for an interrupt entry) and is keyed by that pc
+	 * and the pc of the instruction that cleared it.
+	 */
+	static const uint8_t flags[2] = { I_FLAG, F_FLAG };
+	for (int i=0; i<2; i++) {
+		bool was = old_cc & flags[i];
+		bool is = cc & flags[i];
+		if (!was && is) {
+			mask_start_pc[i] = (interrupt != STAT_INTERRUPTS) ? pc : instruction_pc;
+			mask_start[i] = latency_cycles;
+		} else if (was && !is) {
+			struct masked_period &p =
+				masked_periods[((uint64_t)i << 32) | ((uint64_t)mask_start_pc[i] << 16) | instruction_pc];
+			uint64_t length = latency_cycles + consumed - mask_start[i];
+			p.count++;
+			p.total += length;
+			if (length > p.max) p.max = length;
+		}
+	}
+
+	latency_cycles += consumed;
+}
+
+static void latency_line(FILE *f, const char *name,
+			 const struct mc6809_latency_stats *s)
+{
+	if (s->count == 0) {
+		fprintf(f, "%-8s %10s\n", name, "-");
+		return;
+	}
+	fprintf(f, "%-8s %10llu %8llu %10.1f %8llu\n", name,
+		(unsigned long long)s->count, (unsigned long long)s->min,
+		(double)s->total / s->count, (unsigned long long)s->max);
+}
+
+static void latency_histogram(FILE *f, const char *name,
+			      const struct mc6809_latency_stats *s)
+{
+	if (s->count == 0) return;
+
+	uint64_t most = *std::max_element(s->histogram, s->histogram + LATENCY_BUCKETS);
+	fprintf(f, "%s:\n", name);
+	for (int i=0; i<LATENCY_BUCKETS; i++) {
+		if (s->histogram[i] == 0) continue;
+		char range[32];
+		if (i == 0) {
+			snprintf(range, sizeof(range), "0");
+		} else if (i == LATENCY_BUCKETS - 1) {
+			snprintf(range, sizeof(range), "%llu+", 1ULL << (i - 1));
+		} else {
+			snprintf(range, sizeof(range), "%llu-%llu", 1ULL << (i - 1),
+				(1ULL << i) - 1);
+		}
+		fprintf(f, "  %13s %10llu %.*s\n", range,
+			(unsigned long long)s->histogram[i],
+			(int)((40 * s->histogram[i] + most - 1) / most),
+			"########################################");
+	}
+}
+
+void mc6809::interrupt_latency_report(FILE *f, int masked_entries)
+{
+	fprintf(f, "%-8s %10s %8s %10s %8s\n", "latency", "count", "min", "mean", "max");
+	for (int i=0; i<STAT_SWI; i++) latency_line(f, source_names[i], &latency[i]);
+	fprintf(f, "%-8s %10s %8s %10s %8s\n", "service", "count", "min", "mean", "max");
+	for (int i=0; i<STAT_SWI; i++) latency_line(f, source_names[i], &service[i]);
+
+	for (int i=0; i<STAT_SWI; i++) {
+		char name[32];
+		snprintf(name, sizeof(name), "%s latency", source_names[i]);
+		latency_histogram(f, name, &latency[i]);
+		snprintf(name, sizeof(name), "%s service", source_names[i]);
+		latency_histogram(f, name, &service[i]);
+	}
+
+	std::vector<std::pair<uint64_t, struct masked_period>> periods(
+		masked_periods.begin(), masked_periods.end());
+	std::sort(periods.begin(), periods.end(),
+		[](const std::pair<uint64_t, struct masked_period> &a,
+		   const std::pair<uint64_t, struct masked_period> &b) {
+			return a.second.total > b.second.total;
+		});
+
+	fprintf(f, "masked %-26s %-26s %10s %10s %10s\n", "from", "to", "count", "total", "max");
+	for (int i=0; (i < masked_entries) && (i < (int)periods.size()); i++) {
+		uint64_t key = periods[i].first;
+		const struct masked_period &p = periods[i].second;
+		char start[64], end[64];
+		location_name(start, sizeof(start), (key >> 16) & 0xffff);
+		location_name(end, sizeof(end), key & 0xffff);
+		fprintf(f, "%-6s %-26s %-26s %10llu %10llu %10llu\n",
+			(key >> 32) ? "f" : "i", start, end,
+			(unsigned long long)p.count, (unsigned long long)p.total,
+			(unsigned long long)p.max);
+	}
+}
@@ -0,0 +1,500 @@
+/*
+ * mc6809_opcodes.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Opcode specification. The executor, cycle and disassembler tables are
+ * all generated from it at compile time, one place to change an opcode.
+ * Also the fused handlers for the common load, store and alu opcodes.
+ */
+
+#include "mc6809.hpp"
+
+#define	HNZVC	(H_FLAG | N_FLAG | Z_FLAG | V_FLAG | C_FLAG)
+#define	NZVC	(N_FLAG | Z_FLAG | V_FLAG | C_FLAG)
+#define	NZV	(N_FLAG | Z_FLAG | V_FLAG)
+#define	NZC	(N_FLAG | Z_FLAG | C_FLAG)
+#define	NZ	(N_FLAG | Z_FLAG)
+#define	ZC	(Z_FLAG | C_FLAG)
+#define	EFI	(E_FLAG | F_FLAG | I_FLAG)
+#define	ALL	0xff	// anything that may load cc as a whole
+
+constexpr struct mc6809::opcode_spec mc6809::opcode_specs[] = {
+	// page 1
+	{ 0, 0x00, "neg  ", __DIR_,  6, &mc6809::neg,		NZVC },
+	{ 0, 0x03, "com  ", __DIR_,  6, &mc6809::com,		NZVC },
+	{ 0, 0x04, "lsr  ", __DIR_,  6, &mc6809::lsr,		NZC },
+	{ 0, 0x06, "ror  ", __DIR_,  6, &mc6809::ror,		NZC },
+	{ 0, 0x07, "asr  ", __DIR_,  6, &mc6809::asr,		NZC },
+	{ 0, 0x08, "asl  ", __DIR_,  6, &mc6809::asl,		NZVC },
+	{ 0, 0x09, "rol  ", __DIR_,  6, &mc6809::rol,		NZVC },
+	{ 0, 0x0a, "dec  ", __DIR_,  6, &mc6809::dec,		NZV },
+	{ 0, 0x0c, "inc  ", __DIR_,  6, &mc6809::inc,		NZV },
+	{ 0, 0x0d, "tst  ", __DIR_,  6, &mc6809::tst,		NZV },
+	{ 0, 0x0e, "jmp  ", __DIR_,  3, &mc6809::jmp,		0 },
+	{ 0, 0x0f, "clr  ", __DIR_,  6, &mc6809::clr,		NZVC },
+	{ 0, 0x10, "page2", __INH_,  0, &mc6809::page2,		0 },
+	{ 0, 0x11, "page3", __INH_,  0, &mc6809::page3,		0 },
+	{ 0, 0x12, "nop  ", __INH_,  2, &mc6809::nop,		0 },
+	{ 0, 0x13, "sync ", __INH_,  4, &mc6809::sync,		0 },
+	{ 0, 0x16, "lbra ", __REW_,  5, &mc6809::lbra,		0 },
+	{ 0, 0x17, "lbsr ", __REW_,  9, &mc6809::lbsr,		0 },
+	{ 0, 0x19, "daa  ", __INH_,  2, &mc6809::daa,		NZVC },
+	{ 0, 0x1a, "orcc ", __IBB_,  3, &mc6809::orcc,		ALL },
+	{ 0, 0x1c, "andcc", __IBB_,  3, &mc6809::andcc,		ALL },
+	{ 0, 0x1d, "sex  ", __INH_,  2, &mc6809::sex,		NZ },
+	{ 0, 0x1e, "exg  ", __R1_,   8, &mc6809::exg,		ALL },
+	{ 0, 0x1f, "tfr  ", __R1_,   6, &mc6809::tfr,		ALL },
+	{ 0, 0x20, "bra  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x21, "brn  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x22, "bhi  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x23, "bls  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x24, "bhs  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x25, "blo  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x26, "bne  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x27, "beq  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x28, "bvc  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x29, "bvs  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x2a, "bpl  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x2b, "bmi  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x2c, "bge  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x2d, "blt  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x2e, "bgt  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x2f, "ble  ", __REB_,  3, &mc6809::branch,	0 },
+	{ 0, 0x30, "leax ", __IDX_,  4, &mc6809::leax,		Z_FLAG },
+	{ 0, 0x31, "leay ", __IDX_,  4, &mc6809::leay,		Z_FLAG },
+	{ 0, 0x32, "leas ", __IDX_,  4, &mc6809::leas,		0 },
+	{ 0, 0x33, "leau ", __IDX_,  4, &mc6809::leau,		0 },
+	{ 0, 0x34, "pshs ", __R2_,   5, &mc6809::pshs,		0 },
+	{ 0, 0x35, "puls ", __R2_,   5, &mc6809::puls,		ALL },
+	{ 0, 0x36, "pshu ", __R3_,   5, &mc6809::pshu,		0 },
+	{ 0, 0x37, "pulu ", __R3_,   5, &mc6809::pulu,		ALL },
+	{ 0, 0x39, "rts  ", __INH_,  5, &mc6809::rts,		0 },
+	{ 0, 0x3a, "abx  ", __INH_,  3, &mc6809::abx,		0 },
+	{ 0, 0x3b, "rti  ", __INH_,  6, &mc6809::rti,		ALL },
+	{ 0, 0x3c, "cwai ", __IBB_, 20, &mc6809::cwai,		ALL },
+	{ 0, 0x3d, "mul  ", __INH_, 11, &mc6809::mul,		ZC },
+	{ 0, 0x3f, "swi  ", __INH_, 19, &mc6809::swi,		EFI },
+	{ 0, 0x40, "nega ", __INH_,  2, &mc6809::nega,		NZVC },
+	{ 0, 0x43, "coma ", __INH_,  2, &mc6809::coma,		NZVC },
+	{ 0, 0x44, "lsra ", __INH_,  2, &mc6809::lsra,		NZC },
+	{ 0, 0x46, "rora ", __INH_,  2, &mc6809::rora,		NZC },
+	{ 0, 0x47, "asra ", __INH_,  2, &mc6809::asra,		NZC },
+	{ 0, 0x48, "asla ", __INH_,  2, &mc6809::asla,		NZVC },
+	{ 0, 0x49, "rola ", __INH_,  2, &mc6809::rola,		NZVC },
+	{ 0, 0x4a, "deca ", __INH_,  2, &mc6809::deca,		NZV },
+	{ 0, 0x4c, "inca ", __INH_,  2, &mc6809::inca,		NZV },
+	{ 0, 0x4d, "tsta ", __INH_,  2, &mc6809::tsta,		NZV },
+	{ 0, 0x4f, "clra ", __INH_,  2, &mc6809::clra,		NZVC },
+	{ 0, 0x50, "negb ", __INH_,  2, &mc6809::negb,		NZVC },
+	{ 0, 0x53, "comb ", __INH_,  2, &mc6809::comb,		NZVC },
+	{ 0, 0x54, "lsrb ", __INH_,  2, &mc6809::lsrb,		NZC },
+	{ 0, 0x56, "rorb ", __INH_,  2, &mc6809::rorb,		NZC },
+	{ 0, 0x57, "asrb ", __INH_,  2, &mc6809::asrb,		NZC },
+	{ 0, 0x58, "aslb ", __INH_,  2, &mc6809::aslb,		NZVC },
+	{ 0, 0x59, "rolb ", __INH_,  2, &mc6809::rolb,		NZVC },
+	{ 0, 0x5a, "decb ", __INH_,  2, &mc6809::decb,		NZV },
+	{ 0, 0x5c, "incb ", __INH_,  2, &mc6809::incb,		NZV },
+	{ 0, 0x5d, "tstb ", __INH_,  2, &mc6809::tstb,		NZV },
+	{ 0, 0x5f, "clrb ", __INH_,  2, &mc6809::clrb,		NZVC },
+	{ 0, 0x60, "neg  ", __IDX_,  6, &mc6809::neg,		NZVC },
+	{ 0, 0x63, "com  ", __IDX_,  6, &mc6809::com,		NZVC },
+	{ 0, 0x64, "lsr  ", __IDX_,  6, &mc6809::lsr,		NZC },
+	{ 0, 0x66, "ror  ", __IDX_,  6, &mc6809::ror,		NZC },
+	{ 0, 0x67, "asr  ", __IDX_,  6, &mc6809::asr,		NZC },
+	{ 0, 0x68, "asl  ", __IDX_,  6, &mc6809::asl,		NZVC },
+	{ 0, 0x69, "rol  ", __IDX_,  6, &mc6809::rol,		NZVC },
+	{ 0, 0x6a, "dec  ", __IDX_,  6, &mc6809::dec,		NZV },
+	{ 0, 0x6c, "inc  ", __IDX_,  6, &mc6809::inc,		NZV },
+	{ 0, 0x6d, "tst  ", __IDX_,  6, &mc6809::tst,		NZV },
+	{ 0, 0x6e, "jmp  ", __IDX_,  3, &mc6809::jmp,		0 },
+	{ 0, 0x6f, "clr  ", __IDX_,  6, &mc6809::clr,		NZVC },
+	{ 0, 0x70, "neg  ", __EXT_,  7, &mc6809::neg,		NZVC },
+	{ 0, 0x73, "com  ", __EXT_,  7, &mc6809::com,		NZVC },
+	{ 0, 0x74, "lsr  ", __EXT_,  7, &mc6809::lsr,		NZC },
+	{ 0, 0x76, "ror  ", __EXT_,  7, &mc6809::ror,		NZC },
+	{ 0, 0x77, "asr  ", __EXT_,  7, &mc6809::asr,		NZC },
+	{ 0, 0x78, "asl  ", __EXT_,  7, &mc6809::asl,		NZVC },
+	{ 0, 0x79, "rol  ", __EXT_,  7, &mc6809::rol,		NZVC },
+	{ 0, 0x7a, "dec  ", __EXT_,  7, &mc6809::dec,		NZV },
+	{ 0, 0x7c, "inc  ", __EXT_,  7, &mc6809::inc,		NZV },
+	{ 0, 0x7d, "tst  ", __EXT_,  7, &mc6809::tst,		NZV },
+	{ 0, 0x7e, "jmp  ", __EXT_,  4, &mc6809::jmp,		0 },
+	{ 0, 0x7f, "clr  ", __EXT_,  7, &mc6809::clr,		NZVC },
+	{ 0, 0x80, "suba ", __IMB_,  2, &mc6809::suba,		NZVC, &mc6809::op<SUBA, IMM8> },
+	{ 0, 0x81, "cmpa ", __IMB_,  2, &mc6809::cmpa,		NZVC, &mc6809::op<CMPA, IMM8> },
+	{ 0, 0x82, "sbca ", __IMB_,  2, &mc6809::sbca,		NZVC, &mc6809::op<SBCA, IMM8> },
+	{ 0, 0x83, "subd ", __IMW_,  4, &mc6809::subd,		NZVC, &mc6809::op<SUBD, IMM16> },
+	{ 0, 0x84, "anda ", __IMB_,  2, &mc6809::anda,		NZV, &mc6809::op<ANDA, IMM8> },
+	{ 0, 0x85, "bita ", __IMB_,  2, &mc6809::bita,		NZV, &mc6809::op<BITA, IMM8> },
+	{ 0, 0x86, "lda  ", __IMB_,  2, &mc6809::lda,		NZV, &mc6809::op<LDA, IMM8> },
+	{ 0, 0x88, "eora ", __IMB_,  2, &mc6809::eora,		NZV, &mc6809::op<EORA, IMM8> },
+	{ 0, 0x89, "adca ", __IMB_,  2, &mc6809::adca,		HNZVC, &mc6809::op<ADCA, IMM8> },
+	{ 0, 0x8a, "ora  ", __IMB_,  2, &mc6809::ora,		NZV, &mc6809::op<ORA, IMM8> },
+	{ 0, 0x8b, "adda ", __IMB_,  2, &mc6809::adda,		HNZVC, &mc6809::op<ADDA, IMM8> },
+	{ 0, 0x8c, "cmpx ", __IMW_,  4, &mc6809::cmpx,		NZVC, &mc6809::op<CMPX, IMM16> },
+	{ 0, 0x8d, "bsr  ", __REB_,  7, &mc6809::bsr,		0 },
+	{ 0, 0x8e, "ldx  ", __IMW_,  3, &mc6809::ldx,		NZV, &mc6809::op<LDX, IMM16> },
+	{ 0, 0x90, "suba ", __DIR_,  4, &mc6809::suba,		NZVC, &mc6809::op<SUBA, DIR> },
+	{ 0, 0x91, "cmpa ", __DIR_,  4, &mc6809::cmpa,		NZVC, &mc6809::op<CMPA, DIR> },
+	{ 0, 0x92, "sbca ", __DIR_,  4, &mc6809::sbca,		NZVC, &mc6809::op<SBCA, DIR> },
+	{ 0, 0x93, "subd ", __DIR_,  6, &mc6809::subd,		NZVC, &mc6809::op<SUBD, DIR> },
+	{ 0, 0x94, "anda ", __DIR_,  4, &mc6809::anda,		NZV, &mc6809::op<ANDA, DIR> },
+	{ 0, 0x95, "bita ", __DIR_,  4, &mc6809::bita,		NZV, &mc6809::op<BITA, DIR> },
+	{ 0, 0x96, "lda  ", __DIR_,  4, &mc6809::lda,		NZV, &mc6809::op<LDA, DIR> },
+	{ 0, 0x97, "sta  ", __DIR_,  4, &mc6809::sta,		NZV, &mc6809::op<STA, DIR> },
+	{ 0, 0x98, "eora ", __DIR_,  4, &mc6809::eora,		NZV, &mc6809::op<EORA, DIR> },
+	{ 0, 0x99, "adca ", __DIR_,  4, &mc6809::adca,		HNZVC, &mc6809::op<ADCA, DIR> },
+	{ 0, 0x9a, "ora  ", __DIR_,  4, &mc6809::ora,		NZV, &mc6809::op<ORA, DIR> },
+	{ 0, 0x9b, "adda ", __DIR_,  4, &mc6809::adda,		HNZVC, &mc6809::op<ADDA, DIR> },
+	{ 0, 0x9c, "cmpx ", __DIR_,  6, &mc6809::cmpx,		NZVC, &mc6809::op<CMPX, DIR> },
+	{ 0, 0x9d, "jsr  ", __DIR_,  7, &mc6809::jsr,		0 },
+	{ 0, 0x9e, "ldx  ", __DIR_,  5, &mc6809::ldx,		NZV, &mc6809::op<LDX, DIR> },
+	{ 0, 0x9f, "stx  ", __DIR_,  5, &mc6809::stx,		NZV, &mc6809::op<STX, DIR> },
+	{ 0, 0xa0, "suba ", __IDX_,  4, &mc6809::suba,		NZVC },
+	{ 0, 0xa1, "cmpa ", __IDX_,  4, &mc6809::cmpa,		NZVC },
+	{ 0, 0xa2, "sbca ", __IDX_,  4, &mc6809::sbca,		NZVC },
+	{ 0, 0xa3, "subd ", __IDX_,  6, &mc6809::subd,		NZVC },
+	{ 0, 0xa4, "anda ", __IDX_,  4, &mc6809::anda,		NZV },
+	{ 0, 0xa5, "bita ", __IDX_,  4, &mc6809::bita,		NZV },
+	{ 0, 0xa6, "lda  ", __IDX_,  4, &mc6809::lda,		NZV },
+	{ 0, 0xa7, "sta  ", __IDX_,  4, &mc6809::sta,		NZV },
+	{ 0, 0xa8, "eora ", __IDX_,  4, &mc6809::eora,		NZV },
+	{ 0, 0xa9, "adca ", __IDX_,  4, &mc6809::adca,		HNZVC },
+	{ 0, 0xaa, "ora  ", __IDX_,  4, &mc6809::ora,		NZV },
+	{ 0, 0xab, "adda ", __IDX_,  4, &mc6809::adda,		HNZVC },
+	{ 0, 0xac, "cmpx ", __IDX_,  6, &mc6809::cmpx,		NZVC },
+	{ 0, 0xad, "jsr  ", __IDX_,  7, &mc6809::jsr,		0 },
+	{ 0, 0xae, "ldx  ", __IDX_,  5, &mc6809::ldx,		NZV },
+	{ 0, 0xaf, "stx  ", __IDX_,  5, &mc6809::stx,		NZV },
+	{ 0, 0xb0, "suba ", __EXT_,  5, &mc6809::suba,		NZVC, &mc6809::op<SUBA, EXT> },
+	{ 0, 0xb1, "cmpa ", __EXT_,  5, &mc6809::cmpa,		NZVC, &mc6809::op<CMPA, EXT> },
+	{ 0, 0xb2, "sbca ", __EXT_,  5, &mc6809::sbca,		NZVC, &mc6809::op<SBCA, EXT> },
+	{ 0, 0xb3, "subd ", __EXT_,  7, &mc6809::subd,		NZVC, &mc6809::op<SUBD, EXT> },
+	{ 0, 0xb4, "anda ", __EXT_,  5, &mc6809::anda,		NZV, &mc6809::op<ANDA, EXT> },
+	{ 0, 0xb5, "bita ", __EXT_,  5, &mc6809::bita,		NZV, &mc6809::op<BITA, EXT> },
+	{ 0, 0xb6, "lda  ", __EXT_,  5, &mc6809::lda,		NZV, &mc6809::op<LDA, EXT> },
+	{ 0, 0xb7, "sta  ", __EXT_,  5, &mc6809::sta,		NZV, &mc6809::op<STA, EXT> },
+	{ 0, 0xb8, "eora ", __EXT_,  5, &mc6809::eora,		NZV, &mc6809::op<EORA, EXT> },
+	{ 0, 0xb9, "adca ", __EXT_,  5, &mc6809::adca,		HNZVC, &mc6809::op<ADCA, EXT> },
+	{ 0, 0xba, "ora  ", __EXT_,  5, &mc6809::ora,		NZV, &mc6809::op<ORA, EXT> },
+	{ 0, 0xbb, "adda ", __EXT_,  5, &mc6809::adda,		HNZVC, &mc6809::op<ADDA, EXT> },
+	{ 0, 0xbc, "cmpx ", __EXT_,  7, &mc6809::cmpx,		NZVC, &mc6809::op<CMPX, EXT> },
+	{ 0, 0xbd, "jsr  ", __EXT_,  8, &mc6809::jsr,		0 },
+	{ 0, 0xbe, "ldx  ", __EXT_,  6, &mc6809::ldx,		NZV, &mc6809::op<LDX, EXT> },
+	{ 0, 0xbf, "stx  ", __EXT_,  6, &mc6809::stx,		NZV, &mc6809::op<STX, EXT> },
+	{ 0, 0xc0, "subb ", __IMB_,  2, &mc6809::subb,		NZVC, &mc6809::op<SUBB, IMM8> },
+	{ 0, 0xc1, "cmpb ", __IMB_,  2, &mc6809::cmpb,		NZVC, &mc6809::op<CMPB, IMM8> },
+	{ 0, 0xc2, "sbcb ", __IMB_,  2, &mc6809::sbcb,		NZVC, &mc6809::op<SBCB, IMM8> },
+	{ 0, 0xc3, "addd ", __IMW_,  4, &mc6809::addd,		NZVC, &mc6809::op<ADDD, IMM16> },
+	{ 0, 0xc4, "andb ", __IMB_,  2, &mc6809::andb,		NZV, &mc6809::op<ANDB, IMM8> },
+	{ 0, 0xc5, "bitb ", __IMB_,  2, &mc6809::bitb,		NZV, &mc6809::op<BITB, IMM8> },
+	{ 0, 0xc6, "ldb  ", __IMB_,  2, &mc6809::ldb,		NZV, &mc6809::op<LDB, IMM8> },
+	{ 0, 0xc8, "eorb ", __IMB_,  2, &mc6809::eorb,		NZV, &mc6809::op<EORB, IMM8> },
+	{ 0, 0xc9, "adcb ", __IMB_,  2, &mc6809::adcb,		HNZVC, &mc6809::op<ADCB, IMM8> },
+	{ 0, 0xca, "orb  ", __IMB_,  2, &mc6809::orb,		NZV, &mc6809::op<ORB, IMM8> },
+	{ 0, 0xcb, "addb ", __IMB_,  2, &mc6809::addb,		HNZVC, &mc6809::op<ADDB, IMM8> },
+	{ 0, 0xcc, "ldd  ", __IMW_,  3, &mc6809::ldd,		NZV, &mc6809::op<LDD, IMM16> },
+	{ 0, 0xce, "ldu  ", __IMW_,  3, &mc6809::ldu,		NZV, &mc6809::op<LDU, IMM16> },
+	{ 0, 0xd0, "subb ", __DIR_,  4, &mc6809::subb,		NZVC, &mc6809::op<SUBB, DIR> },
+	{ 0, 0xd1, "cmpb ", __DIR_,  4, &mc6809::cmpb,		NZVC, &mc6809::op<CMPB, DIR> },
+	{ 0, 0xd2, "sbcb ", __DIR_,  4, &mc6809::sbcb,		NZVC, &mc6809::op<SBCB, DIR> },
+	{ 0, 0xd3, "addd ", __DIR_,  6, &mc6809::addd,		NZVC, &mc6809::op<ADDD, DIR> },
+	{ 0, 0xd4, "andb ", __DIR_,  4, &mc6809::andb,		NZV, &mc6809::op<ANDB, DIR> },
+	{ 0, 0xd5, "bitb ", __DIR_,  4, &mc6809::bitb,		NZV, &mc6809::op<BITB, DIR> },
+	{ 0, 0xd6, "ldb  ", __DIR_,  4, &mc6809::ldb,		NZV, &mc6809::op<LDB, DIR> },
+	{ 0, 0xd7, "stb  ", __DIR_,  4, &mc6809::stb,		NZV, &mc6809::op<STB, DIR> },
+	{ 0, 0xd8, "eorb ", __DIR_,  4, &mc6809::eorb,		NZV, &mc6809::op<EORB, DIR> },
+	{ 0, 0xd9, "adcb ", __DIR_,  4, &mc6809::adcb,		HNZVC, &mc6809::op<ADCB, DIR> },
+	{ 0, 0xda, "orb  ", __DIR_,  4, &mc6809::orb,		NZV, &mc6809::op<ORB, DIR> },
+	{ 0, 0xdb, "addb ", __DIR_,  4, &mc6809::addb,		HNZVC, &mc6809::op<ADDB, DIR> },
+	{ 0, 0xdc, "ldd  ", __DIR_,  5, &mc6809::ldd,		NZV, &mc6809::op<LDD, DIR> },
+	{ 0, 0xdd, "std  ", __DIR_,  5, &mc6809::std,		NZV, &mc6809::op<STD, DIR> },
+	{ 0, 0xde, "ldu  ", __DIR_,  5, &mc6809::ldu,		NZV, &mc6809::op<LDU, DIR> },
+	{ 0, 0xdf, "stu  ", __DIR_,  5, &mc6809::stu,		NZV, &mc6809::op<STU, DIR> },
+	{ 0, 0xe0, "subb ", __IDX_,  4, &mc6809::subb,		NZVC },
+	{ 0, 0xe1, "cmpb ", __IDX_,  4, &mc6809::cmpb,		NZVC },
+	{ 0, 0xe2, "sbcb ", __IDX_,  4, &mc6809::sbcb,		NZVC },
+	{ 0, 0xe3, "addd ", __IDX_,  6, &mc6809::addd,		NZVC },
+	{ 0, 0xe4, "andb ", __IDX_,  4, &mc6809::andb,		NZV },
+	{ 0, 0xe5, "bitb ", __IDX_,  4, &mc6809::bitb,		NZV },
+	{ 0, 0xe6, "ldb  ", __IDX_,  4, &mc6809::ldb,		NZV },
+	{ 0, 0xe7, "stb  ", __IDX_,  4, &mc6809::stb,		NZV },
+	{ 0, 0xe8, "eorb ", __IDX_,  4, &mc6809::eorb,		NZV },
+	{ 0, 0xe9, "adcb ", __IDX_,  4, &mc6809::adcb,		HNZVC },
+	{ 0, 0xea, "orb  ", __IDX_,  4, &mc6809::orb,		NZV },
+	{ 0, 0xeb, "addb ", __IDX_,  4, &mc6809::addb,		HNZVC },
+	{ 0, 0xec, "ldd  ", __IDX_,  5, &mc6809::ldd,		NZV },
+	{ 0, 0xed, "std  ", __IDX_,  5, &mc6809::std,		NZV },
+	{ 0, 0xee, "ldu  ", __IDX_,  5, &mc6809::ldu,		NZV },
+	{ 0, 0xef, "stu  ", __IDX_,  5, &mc6809::stu,		NZV },
+	{ 0, 0xf0, "subb ", __EXT_,  5, &mc6809::subb,		NZVC, &mc6809::op<SUBB, EXT> },
+	{ 0, 0xf1, "cmpb ", __EXT_,  5, &mc6809::cmpb,		NZVC, &mc6809::op<CMPB, EXT> },
+	{ 0, 0xf2, "sbcb ", __EXT_,  5, &mc6809::sbcb,		NZVC, &mc6809::op<SBCB, EXT> },
+	{ 0, 0xf3, "addd ", __EXT_,  7, &mc6809::addd,		NZVC, &mc6809::op<ADDD, EXT> },
+	{ 0, 0xf4, "andb ", __EXT_,  5, &mc6809::andb,		NZV, &mc6809::op<ANDB, EXT> },
+	{ 0, 0xf5, "bitb ", __EXT_,  5, &mc6809::bitb,		NZV, &mc6809::op<BITB, EXT> },
+	{ 0, 0xf6, "ldb  ", __EXT_,  5, &mc6809::ldb,		NZV, &mc6809::op<LDB, EXT> },
+	{ 0, 0xf7, "stb  ", __EXT_,  5, &mc6809::stb,		NZV, &mc6809::op<STB, EXT> },
+	{ 0, 0xf8, "eorb ", __EXT_,  5, &mc6809::eorb,		NZV, &mc6809::op<EORB, EXT> },
+	{ 0, 0xf9, "adcb ", __EXT_,  5, &mc6809::adcb,		HNZVC, &mc6809::op<ADCB, EXT> },
+	{ 0, 0xfa, "orb  ", __EXT_,  5, &mc6809::orb,		NZV, &mc6809::op<ORB, EXT> },
+	{ 0, 0xfb, "addb ", __EXT_,  5, &mc6809::addb,		HNZVC, &mc6809::op<ADDB, EXT> },
+	{ 0, 0xfc, "ldd  ", __EXT_,  6, &mc6809::ldd,		NZV, &mc6809::op<LDD, EXT> },
+	{ 0, 0xfd, "std  ", __EXT_,  6, &mc6809::std,		NZV, &mc6809::op<STD, EXT> },
+	{ 0, 0xfe, "ldu  ", __EXT_,  6, &mc6809::ldu,		NZV, &mc6809::op<LDU, EXT> },
+	{ 0, 0xff, "stu  ", __EXT_,  6, &mc6809::stu,		NZV, &mc6809::op<STU, EXT> },
+
+	// page 2 ($10 prefix)
+	{ 1, 0x21, "lbrn ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x22, "lbhi ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x23, "lbls ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x24, "lbhs ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x25, "lblo ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x26, "lbne ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x27, "lbeq ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x28, "lbvc ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x29, "lbvs ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x2a, "lbpl ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x2b, "lbmi ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x2c, "lbge ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x2d, "lblt ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x2e, "lbgt ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x2f, "lble ", __REW_,  5, &mc6809::long_branch,	0 },
+	{ 1, 0x3f, "swi2 ", __INH_, 20, &mc6809::swi2,		E_FLAG },
+	{ 1, 0x83, "cmpd ", __IMW_,  5, &mc6809::cmpd,		NZVC, &mc6809::op<CMPD, IMM16> },
+	{ 1, 0x8c, "cmpy ", __IMW_,  5, &mc6809::cmpy,		NZVC, &mc6809::op<CMPY, IMM16> },
+	{ 1, 0x8e, "ldy  ", __IMW_,  4, &mc6809::ldy,		NZV, &mc6809::op<LDY, IMM16> },
+	{ 1, 0x93, "cmpd ", __DIR_,  7, &mc6809::cmpd,		NZVC, &mc6809::op<CMPD, DIR> },
+	{ 1, 0x9c, "cmpy ", __DIR_,  7, &mc6809::cmpy,		NZVC, &mc6809::op<CMPY, DIR> },
+	{ 1, 0x9e, "ldy  ", __DIR_,  6, &mc6809::ldy,		NZV, &mc6809::op<LDY, DIR> },
+	{ 1, 0x9f, "sty  ", __DIR_,  6, &mc6809::sty,		NZV, &mc6809::op<STY, DIR> },
+	{ 1, 0xa3, "cmpd ", __IDX_,  7, &mc6809::cmpd,		NZVC },
+	{ 1, 0xac, "cmpy ", __IDX_,  7, &mc6809::cmpy,		NZVC },
+	{ 1, 0xae, "ldy  ", __IDX_,  6, &mc6809::ldy,		NZV },
+	{ 1, 0xaf, "sty  ", __IDX_,  6, &mc6809::sty,		NZV },
+	{ 1, 0xb3, "cmpd ", __EXT_,  8, &mc6809::cmpd,		NZVC, &mc6809::op<CMPD, EXT> },
+	{ 1, 0xbc, "cmpy ", __EXT_,  8, &mc6809::cmpy,		NZVC, &mc6809::op<CMPY, EXT> },
+	{ 1, 0xbe, "ldy  ", __EXT_,  7, &mc6809::ldy,		NZV, &mc6809::op<LDY, EXT> },
+	{ 1, 0xbf, "sty  ", __EXT_,  7, &mc6809::sty,		NZV, &mc6809::op<STY, EXT> },
+	{ 1, 0xce, "lds  ", __IMW_,  4, &mc6809::lds,		NZV, &mc6809::op<LDS, IMM16> },
+	{ 1, 0xde, "lds  ", __DIR_,  6, &mc6809::lds,		NZV, &mc6809::op<LDS, DIR> },
+	{ 1, 0xdf, "sts  ", __DIR_,  6, &mc6809::sts,		NZV, &mc6809::op<STS, DIR> },
+	{ 1, 0xee, "lds  ", __IDX_,  6, &mc6809::lds,		NZV },
+	{ 1, 0xef, "sts  ", __IDX_,  6, &mc6809::sts,		NZV },
+	{ 1, 0xfe, "lds  ", __EXT_,  7, &mc6809::lds,		NZV, &mc6809::op<LDS, EXT> },
+	{ 1, 0xff, "sts  ", __EXT_,  7, &mc6809::sts,		NZV, &mc6809::op<STS, EXT> },
+
+	// page 3 ($11 prefix)
+	{ 2, 0x3e, "sys  ", __IMB_,  5, &mc6809::sys,		ALL, &mc6809::op<SYS, IMM8> },
+	{ 2, 0x3f, "swi3 ", __INH_, 20, &mc6809::swi3,		E_FLAG },
+	{ 2, 0x83, "cmpu ", __IMW_,  5, &mc6809::cmpu,		NZVC, &mc6809::op<CMPU, IMM16> },
+	{ 2, 0x8c, "cmps ", __IMW_,  5, &mc6809::cmps,		NZVC, &mc6809::op<CMPS, IMM16> },
+	{ 2, 0x93, "cmpu ", __DIR_,  7, &mc6809::cmpu,		NZVC, &mc6809::op<CMPU, DIR> },
+	{ 2, 0x9c, "cmps ", __DIR_,  7, &mc6809::cmps,		NZVC, &mc6809::op<CMPS, DIR> },
+	{ 2, 0xa3, "cmpu ", __IDX_,  7, &mc6809::cmpu,		NZVC },
+	{ 2, 0xac, "cmps ", __IDX_,  7, &mc6809::cmps,		NZVC },
+	{ 2, 0xb3, "cmpu ", __EXT_,  8, &mc6809::cmpu,		NZVC, &mc6809::op<CMPU, EXT> },
+	{ 2, 0xbc, "cmps ", __EXT_,  8, &mc6809::cmps,		NZVC, &mc6809::op<CMPS, EXT> }
+};
+
+#undef	HNZVC
+#undef	NZVC
+#undef	NZV
+#undef	NZC
+#undef	NZ
+#undef	ZC
+#undef	EFI
+#undef	ALL
+
+/*
+ * The addressing mode function for each operand mode, in the order of
+ * enum addr_mode_index. The page prefixes ($10, $11) are inherent on
+ * page 1, the page2() and page3() handlers fetch the second opcode
+ * themselves. Likewise, andcc, orcc, exg, tfr and the push and pull
+ * instructions fetch their postbyte with fetch8(), so it is never
+ * seen by the watchpoints.
+ */
+constexpr mc6809::addressing_mode mc6809::mode_functions[] = {
+	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_reb,	&mc6809::a_rew,
+	&mc6809::a_imb,	&mc6809::a_imw,	&mc6809::a_ih,	&mc6809::a_ext,
+	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,
+	&mc6809::a_idx
+};
+
+/*
+ * Generic handler for entry spec. Both member pointers are constants,
+ * so these are direct calls.
+ */
+template <size_t spec>
+void mc6809::execute_spec()
+{
+	bool am_legal;
+	uint16_t effective_address = (this->*mode_functions[opcode_specs[spec].mode])(&am_legal);
+	if (am_legal) {
+		(this->*opcode_specs[spec].handler)(effective_address);
+	} else {
+		ill(effective_address);
+	}
+}
+
+void mc6809::execute_illegal()
+{
+	ill(0);
+}
+
+template <int mode>
+inline uint16_t mc6809::fused_address()
+{
+	uint16_t address;
+
+	switch (mode) {
+	case IMM8:
+		return pc++;
+	case IMM16:
+		address = pc;
+		pc += 2;
+		return address;
+	case DIR:
+		return (dp << 8) | fetch8();
+	default:
+		address = fetch8() << 8;
+		return address | fetch8();
+	}
+}
+
+template <int mode>
+inline uint8_t mc6809::fused_read8()
+{
+	if (mode == IMM8) return fetch8();
+	return bus_read8(fused_address<mode>());
+}
+
+template <int mode>
+inline uint16_t mc6809::fused_read16()
+{
+	uint16_t value;
+
+	if (mode == IMM16) {
+		value = fetch8() << 8;
+		return value | fetch8();
+	}
+	uint16_t address = fused_address<mode>();
+	value = bus_read8(address++) << 8;
+	return value | bus_read8(address);
+}
+
+template <int operation, int mode>
+void mc6809::op()
+{
+	uint16_t address, value;
+
+	switch (operation) {
+	case SUBA: ac = sub8(ac, fused_read8<mode>(), 0); break;
+	case SUBB: br = sub8(br, fused_read8<mode>(), 0); break;
+	case CMPA: sub8(ac, fused_read8<mode>(), 0); break;
+	case CMPB: sub8(br, fused_read8<mode>(), 0); break;
+	case SBCA: ac = sub8(ac, fused_read8<mode>(), is_c_flag_set() ? 1 : 0); break;
+	case SBCB: br = sub8(br, fused_read8<mode>(), is_c_flag_set() ? 1 : 0); break;
+	case ADDA: ac = add8(ac, fused_read8<mode>(), 0); break;
+	case ADDB: br = add8(br, fused_read8<mode>(), 0); break;
+	case ADCA: ac = add8(ac, fused_read8<mode>(), is_c_flag_set() ? 1 : 0); break;
+	case ADCB: br = add8(br, fused_read8<mode>(), is_c_flag_set() ? 1 : 0); break;
+	case ANDA: ac &= fused_read8<mode>(); clear_v_flag(); test_nz_flags(ac); break;
+	case ANDB: br &= fused_read8<mode>(); clear_v_flag(); test_nz_flags(br); break;
+	case BITA: clear_v_flag(); test_nz_flags(ac & fused_read8<mode>()); break;
+	case BITB: clear_v_flag(); test_nz_flags(br & fused_read8<mode>()); break;
+	case EORA: ac ^= fused_read8<mode>(); clear_v_flag(); test_nz_flags(ac); break;
+	case EORB: br ^= fused_read8<mode>(); clear_v_flag(); test_nz_flags(br); break;
+	case ORA:  ac |= fused_read8<mode>(); clear_v_flag(); test_nz_flags(ac); break;
+	case ORB:  br |= fused_read8<mode>(); clear_v_flag(); test_nz_flags(br); break;
+	case LDA:  ac = fused_read8<mode>(); clear_v_flag(); test_nz_flags(ac); break;
+	case LDB:  br = fused_read8<mode>(); clear_v_flag(); test_nz_flags(br); break;
+	case STA:  bus_write8(fused_address<mode>(), ac); clear_v_flag(); test_nz_flags(ac); break;
+	case STB:  bus_write8(fused_address<mode>(), br); clear_v_flag(); test_nz_flags(br); break;
+
+	case SUBD:
+	case ADDD:
+		value = fused_read16<mode>();
+		value = (operation == SUBD) ? sub16((ac << 8) | br, value) : add16((ac << 8) | br, value);
+		ac = value >> 8;
+		br = value & 0xff;
+		break;
+	case CMPD: sub16((ac << 8) | br, fused_read16<mode>()); break;
+	case CMPX: sub16(xr, fused_read16<mode>()); break;
+	case CMPY: sub16(yr, fused_read16<mode>()); break;
+	case CMPU: sub16(us, fused_read16<mode>()); break;
+	case CMPS: sub16(sp, fused_read16<mode>()); break;
+
+	case LDD:
+		value = fused_read16<mode>();
+		ac = value >> 8;
+		br = value & 0xff;
+		clear_v_flag();
+		test_nz_flags_16(value);
+		break;
+	case LDX: xr = fused_read16<mode>(); clear_v_flag(); test_nz_flags_16(xr); break;
+	case LDY: yr = fused_read16<mode>(); clear_v_flag(); test_nz_flags_16(yr); break;
+	case LDU: us = fused_read16<mode>(); clear_v_flag(); test_nz_flags_16(us); break;
+	case LDS:
+		sp = fused_read16<mode>();
+		clear_v_flag();
+		test_nz_flags_16(sp);
+		// a write to system stackpointer enables nmi's
+		nmi_enabled = true;
+		break;
+
+	case SYS:
+		value = fused_read8<mode>();
+		if (syscall_gate == SYSCALL_GATE_OPCODE) {
+			do_syscall(value);
+		} else {
+			ill(0);
+		}
+		break;
+
+	default:
+		value = (operation == STD) ? ((ac << 8) | br) :
+			(operation == STX) ? xr :
+			(operation == STY) ? yr :
+			(operation == STU) ? us : sp;
+		address = fused_address<mode>();
+		bus_write8(address++, value >> 8);
+		bus_write8(address, value & 0xff);
+		clear_v_flag();
+		test_nz_flags_16(value);
+		break;
+	}
+}
+
+template <size_t... spec>
+constexpr struct mc6809::opcode_tables mc6809::generate_opcode_tables(std::index_sequence<spec...>)
+{
+	const opcode_handler generic[] = { &mc6809::execute_spec<spec>... };
+
+	struct opcode_tables t {};
+
+	for (int p=0; p<3; p++) {
+		for (int i=0; i<256; i++) {
+			t.execute[p][i] = &mc6809::execute_illegal;
+			t.cycles[p][i] = 0;
+			t.mnemonics[p][i] = "???  ";
+			t.operands[p][i] = __NOM_;
+			t.flags[p][i] = 0;
+		}
+	}
+
+	for (size_t i=0; i<sizeof...(spec); i++) {
+		const struct opcode_spec &s = opcode_specs[i];
+		t.execute[s.page][s.opcode] = s.fused ? s.fused : generic[i];
+		t.cycles[s.page][s.opcode] = s.cycles;
+		t.mnemonics[s.page][s.opcode] = s.mnemonic;
+		t.operands[s.page][s.opcode] = s.mode;
+		t.flags[s.page][s.opcode] = s.flags;
+	}
+
+	return t;
+}
+
+constexpr struct mc6809::opcode_tables mc6809::opcode_table = mc6809::generate_opcode_tables(
+	std::make_index_sequence<sizeof(opcode_specs) / sizeof(opcode_specs[0])>());
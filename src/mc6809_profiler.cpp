@@ -0,0 +1,86 @@
+/*
+ * mc6809_profiler.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Per pc execution and cycle profiler
+ */
+
+#include "mc6809.hpp"
+#include <algorithm>
+#include <cstring>
+
+void mc6809::enable_profiler(bool enable)
+{
+	if (enable) {
+		if (profile_instructions == NULL) {
+			profile_instructions = new uint64_t[65536]();
+			profile_cycles = new uint64_t[65536]();
+		}
+		instruments |= INSTRUMENT_PROFILER;
+	} else {
+		instruments &= ~INSTRUMENT_PROFILER;
+	}
+}
+
+void mc6809::reset_profiler()
+{
+	if (profile_instructions) {
+		memset(profile_instructions, 0, 65536 * sizeof(uint64_t));
+		memset(profile_cycles, 0, 65536 * sizeof(uint64_t));
+	}
+}
+
+uint64_t mc6809::get_profile_instructions(uint16_t address)
+{
+	return profile_instructions ? profile_instructions[address] : 0;
+}
+
+uint64_t mc6809::get_profile_cycles(uint16_t address)
+{
+	return profile_cycles ? profile_cycles[address] : 0;
+}
+
+/*
+ * Writes the hottest addresses (by cycles) to f, each line annotated
+ * with its disassembly.
+ */
+void mc6809::profiler_report(FILE *f, int entries)
+{
+	if (profile_cycles == NULL) {
+		fprintf(f, "profiler not enabled\n");
+		return;
+	}
+
+	uint64_t total_cycles = 0;
+	uint64_t total_instructions = 0;
+	std::vector<uint16_t> addresses;
+	for (int i=0; i<65536; i++) {
+		if (profile_instructions[i]) {
+			addresses.push_back(i);
+			total_cycles += profile_cycles[i];
+			total_instructions += profile_instructions[i];
+		}
+	}
+
+	std::sort(addresses.begin(), addresses.end(),
+		[this](uint16_t a, uint16_t b) {
+			return profile_cycles[a] > profile_cycles[b];
+		});
+
+	fprintf(f, "instructions: %llu  cycles: %llu\n",
+		(unsigned long long)total_instructions,
+		(unsigned long long)total_cycles);
+	fprintf(f, "      cycles      %%  instructions  address\n");
+
+	char buffer[64];
+	for (size_t i=0; (i < addresses.size()) && ((int)i < entries); i++) {
+		uint16_t address = addresses[i];
+		disassemble_instruction(buffer, sizeof(buffer), address);
+		fprintf(f, "%12llu %6.2f %13llu  %s\n",
+			(unsigned long long)profile_cycles[address],
+			100.0 * profile_cycles[address] / total_cycles,
+			(unsigned long long)profile_instructions[address],
+			buffer);
+	}
+}
@@ -0,0 +1,157 @@
+/*
+ * mc6809_sampler.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Sampling profiler with folded stack output (flamegraph.pl)
+ */
+
+#include "mc6809.hpp"
+#include <algorithm>
+#include <cstring>
+
+void mc6809::enable_sampler(bool enable, uint32_t period)
+{
+	if (enable) {
+		if (samples == NULL) {
+			samples = new struct sampler_stack[SAMPLER_SLOTS]();
+		}
+		sampler_period = period ? period : 1;
+		sampler_countdown = sampler_period;
+	} else {
+		sampler_period = 0;
+		sampler_countdown = INT32_MAX;
+	}
+}
+
+void mc6809::reset_sampler()
+{
+	if (samples) {
+		memset(samples, 0, SAMPLER_SLOTS * sizeof(struct sampler_stack));
+	}
+	sampler_stacks = 0;
+	samples_dropped = 0;
+}
+
+/*
+ * Is address the return address of a jsr, bsr or lbsr? Indexed jsr is
+ * only recognized without offset bytes.
+ */
+bool mc6809::return_address(uint16_t address)
+{
+	switch (read8(address - 2)) {
+	case 0x8d:	// bsr
+	case 0x9d:	// jsr direct
+	case 0xad:	// jsr indexed
+		return true;
+	}
+	switch (read8(address - 3)) {
+	case 0x17:	// lbsr
+	case 0xbd:	// jsr extended
+		return true;
+	}
+	return false;
+}
+
+/*
+ * The stack walk is heuristic: words on the s stack that point right
+ * after a call instruction are taken as return addresses. Only bus free
+ * read8() is used. Nothing is allocated, a new stack takes a free slot
+ * of the table and is dropped when the table is full.
+ */
+void mc6809::take_sample()
+{
+	if (sampler_period == 0) {
+		// off, INT32_MAX cycles have passed
+		sampler_countdown = INT32_MAX;
+		return;
+	}
+
+	/*
+	 * xorshift32, next countdown between 0.5 and 1.5 period
+	 */
+	sampler_random ^= sampler_random << 13;
+	sampler_random ^= sampler_random >> 17;
+	sampler_random ^= sampler_random << 5;
+	sampler_countdown += (sampler_period >> 1) + (sampler_random % (sampler_period + 1));
+
+	uint8_t bytes[SAMPLER_STACK_BYTES];
+	for (int i=0; i<SAMPLER_STACK_BYTES; i++) {
+		bytes[i] = read8(sp + i);
+	}
+
+	struct sampler_stack stack;
+	stack.depth = 0;
+
+	for (int i=0; (i < SAMPLER_STACK_BYTES - 1) && (stack.depth < SAMPLER_MAX_DEPTH); i++) {
+		uint16_t word = (bytes[i] << 8) | bytes[i + 1];
+		if (return_address(word)) {
+			stack.frames[stack.depth++] = word;
+			i++;
+		}
+	}
+
+	/*
+	 * Outermost frame first, the sampled pc last
+	 */
+	std::reverse(stack.frames, stack.frames + stack.depth);
+	stack.frames[stack.depth++] = pc;
+
+	uint32_t hash = 2166136261;	// fnv-1a
+	for (int i=0; i<stack.depth; i++) {
+		hash = (hash ^ stack.frames[i]) * 16777619;
+	}
+
+	for (uint32_t slot = hash; ; slot++) {
+		struct sampler_stack &s = samples[slot & (SAMPLER_SLOTS - 1)];
+		if (s.count == 0) {
+			if (sampler_stacks == (SAMPLER_SLOTS / 4) * 3) {
+				samples_dropped++;
+			} else {
+				s = stack;
+				s.count = 1;
+				sampler_stacks++;
+			}
+			return;
+		}
+		if ((s.depth == stack.depth) &&
+		    std::equal(stack.frames, stack.frames + stack.depth, s.frames)) {
+			s.count++;
+			return;
+		}
+	}
+}
+
+bool mc6809::write_folded_stacks(const char *filename)
+{
+	FILE *f = fopen(filename, "w");
+	if (f == NULL) return false;
+
+	/*
+	 * Different addresses can resolve to the same names, flamegraph.pl
+	 * adds up equal lines.
+	 */
+	char name[64];
+	for (uint32_t slot=0; samples && (slot < SAMPLER_SLOTS); slot++) {
+		const struct sampler_stack &s = samples[slot];
+		if (s.count == 0) continue;
+		for (int i=0; i<s.depth; i++) {
+			/*
+			 * A return address is named after its call site, in
+			 * case the call is the last instruction of a routine.
+			 */
+			uint16_t address = s.frames[i];
+			if (i != s.depth - 1) address--;
+			location_name(name, sizeof(name), address);
+			fprintf(f, "%s%s", i ? ";" : "", name);
+		}
+		fprintf(f, " %llu\n", (unsigned long long)s.count);
+	}
+
+	fclose(f);
+	if (samples_dropped) {
+		printf("[MC6809] %llu samples dropped, table full at %i stacks\n",
+		       (unsigned long long)samples_dropped, (SAMPLER_SLOTS / 4) * 3);
+	}
+	return true;
+}
@@ -0,0 +1,165 @@
+/*
+ * mc6809_statistics.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Dynamic instruction mix statistics
+ */
+
+#include "mc6809.hpp"
+#include <cstring>
+
+static const char *interrupt_names[STAT_INTERRUPTS] = {
+	"nmi", "firq", "irq", "swi", "swi2", "swi3"
+};
+
+static const char *indexed_names[STAT_IDX_CLASSES] = {
+	",r+",    ",r++",   ",-r",    ",--r",
+	",r",     "b,r",    "a,r",    "ill7",
+	"n8,r",   "n16,r",  "illa",   "d,r",
+	"n8,pcr", "n16,pcr","ille",   "ext",
+	"n5,r"
+};
+
+void mc6809::enable_statistics(bool enable)
+{
+	if (enable) {
+		instruments |= INSTRUMENT_STATISTICS;
+	} else {
+		instruments &= ~INSTRUMENT_STATISTICS;
+	}
+}
+
+void mc6809::reset_statistics()
+{
+	memset(opcode_counts, 0, sizeof(opcode_counts));
+	memset(indexed_counts, 0, sizeof(indexed_counts));
+	memset(interrupt_counts, 0, sizeof(interrupt_counts));
+}
+
+uint64_t mc6809::get_opcode_count(int page, uint8_t opcode)
+{
+	return ((page >= 1) && (page <= 3)) ? opcode_counts[page - 1][opcode] : 0;
+}
+
+uint64_t mc6809::get_indexed_count(int postbyte_class, bool indirect)
+{
+	if ((postbyte_class < 0) || (postbyte_class >= STAT_IDX_CLASSES))
+		return 0;
+	return indexed_counts[indirect ? 1 : 0][postbyte_class];
+}
+
+uint64_t mc6809::get_interrupt_count(enum statistics_interrupt_t vector)
+{
+	return interrupt_counts[vector];
+}
+
+/*
+ * Called after an instruction has run, counts it from the bytes it
+ * fetched: the prefix, opcode and indexed postbyte.
+ */
+void mc6809::count_instruction()
+{
+	int page = 0;
+	int operand = 1;
+	uint8_t opcode = fetched[0];
+
+	if ((opcode == 0x10) || (opcode == 0x11)) {
+		page = opcode - 0x0f;
+		opcode = fetched[operand++];
+	}
+
+	opcode_counts[page][opcode]++;
+
+	if (opcode_table.operands[page][opcode] == __IDX_) {
+		uint8_t postbyte = fetched[operand];
+		if (postbyte & 0b10000000) {
+			indexed_counts[(postbyte & 0b00010000) ? 1 : 0][postbyte & 0b00001111]++;
+		} else {
+			indexed_counts[0][STAT_IDX_OFFSET5]++;
+		}
+	}
+
+	/*
+	 * A swi3 taken by the syscall gate doesn't enter an interrupt
+	 */
+	if ((opcode == 0x3f) &&
+	    !((page == 2) && (syscall_gate == SYSCALL_GATE_SWI3))) {
+		interrupt_counts[STAT_SWI + page]++;
+	}
+}
+
+/*
+ * Mnemonics are padded with spaces, these are left out of the output.
+ */
+static int mnemonic_length(const char *mnemonic)
+{
+	return strcspn(mnemonic, " ");
+}
+
+void mc6809::statistics_csv(FILE *f)
+{
+	fprintf(f, "type,page,opcode,name,count\n");
+	for (int page=0; page<3; page++) {
+		for (int i=0; i<256; i++) {
+			if (opcode_counts[page][i] == 0) continue;
+			const char *m = opcode_mnemonic(page + 1, i);
+			fprintf(f, "opcode,%i,$%02x,\"%.*s\",%llu\n", page + 1, i,
+				mnemonic_length(m), m,
+				(unsigned long long)opcode_counts[page][i]);
+		}
+	}
+	for (int indirect=0; indirect<2; indirect++) {
+		for (int i=0; i<STAT_IDX_CLASSES; i++) {
+			if (indexed_counts[indirect][i] == 0) continue;
+			fprintf(f, "indexed,,,\"%s%s%s\",%llu\n",
+				indirect ? "[" : "", indexed_names[i],
+				indirect ? "]" : "",
+				(unsigned long long)indexed_counts[indirect][i]);
+		}
+	}
+	for (int i=0; i<STAT_INTERRUPTS; i++) {
+		fprintf(f, "interrupt,,,\"%s\",%llu\n", interrupt_names[i],
+			(unsigned long long)interrupt_counts[i]);
+	}
+}
+
+void mc6809::statistics_json(FILE *f)
+{
+	bool first = true;
+
+	fprintf(f, "{\n  \"opcodes\": [");
+	for (int page=0; page<3; page++) {
+		for (int i=0; i<256; i++) {
+			if (opcode_counts[page][i] == 0) continue;
+			const char *m = opcode_mnemonic(page + 1, i);
+			fprintf(f, "%s\n    { \"page\": %i, \"opcode\": %i, "
+				"\"mnemonic\": \"%.*s\", \"count\": %llu }",
+				first ? "" : ",", page + 1, i,
+				mnemonic_length(m), m,
+				(unsigned long long)opcode_counts[page][i]);
+			first = false;
+		}
+	}
+
+	first = true;
+	fprintf(f, "\n  ],\n  \"indexed\": [");
+	for (int indirect=0; indirect<2; indirect++) {
+		for (int i=0; i<STAT_IDX_CLASSES; i++) {
+			if (indexed_counts[indirect][i] == 0) continue;
+			fprintf(f, "%s\n    { \"mode\": \"%s\", \"indirect\": %s, "
+				"\"count\": %llu }",
+				first ? "" : ",", indexed_names[i],
+				indirect ? "true" : "false",
+				(unsigned long long)indexed_counts[indirect][i]);
+			first = false;
+		}
+	}
+
+	fprintf(f, "\n  ],\n  \"interrupts\": {");
+	for (int i=0; i<STAT_INTERRUPTS; i++) {
+		fprintf(f, "%s \"%s\": %llu", i ? "," : "", interrupt_names[i],
+			(unsigned long long)interrupt_counts[i]);
+	}
+	fprintf(f, " }\n}\n");
+}
@@ -0,0 +1,94 @@
+/*
+ * mc6809_symbols.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Guest symbols from a vlink map file
+ */
+
+#include "mc6809.hpp"
+#include <algorithm>
+#include <cstring>
+
+/*
+ * Reads the symbol lines of a map file written by vlink -M, e.g.
+ *
+ *   0x0000e000 reset: global reloc, value 0xe000, size 0
+ *
+ * Other lines are ignored. Returns false if the file can't be opened.
+ */
+bool mc6809::load_symbols(const char *filename)
+{
+	FILE *f = fopen(filename, "r");
+	if (f == NULL) return false;
+
+	char line[256];
+	while (fgets(line, sizeof(line), f)) {
+		unsigned long value;
+		char name[48];
+		char colon;
+		if ((sscanf(line, " 0x%lx %47[^: \t\n]%c", &value, name, &colon) == 3) &&
+		    (colon == ':') && (value <= 0xffff)) {
+			struct symbol s;
+			s.address = value;
+			snprintf(s.name, sizeof(s.name), "%s", name);
+			symbols.push_back(s);
+		}
+	}
+	fclose(f);
+
+	std::stable_sort(symbols.begin(), symbols.end(),
+		[](const struct symbol &a, const struct symbol &b) {
+			return a.address < b.address;
+		});
+	return true;
+}
+
+void mc6809::clear_symbols()
+{
+	symbols.clear();
+}
+
+/*
+ * Name of the first symbol at address, NULL if there's none.
+ */
+const char *mc6809::get_symbol(uint16_t address)
+{
+	std::vector<struct symbol>::iterator i = std::lower_bound(symbols.begin(),
+		symbols.end(), address,
+		[](const struct symbol &s, uint16_t a) { return s.address < a; });
+	if ((i != symbols.end()) && (i->address == address)) {
+		return i->name;
+	}
+	return NULL;
+}
+
+/*
+ * Symbol name, or the address itself, of a function entry.
+ */
+void mc6809::function_name(char *buffer, size_t n, uint32_t function)
+{
+	if (function == CALLGRAPH_ROOT) {
+		snprintf(buffer, n, "(toplevel)");
+	} else if (const char *name = get_symbol(function)) {
+		snprintf(buffer, n, "%s", name);
+	} else {
+		snprintf(buffer, n, "$%04x", function);
+	}
+}
+
+/*
+ * Nearest symbol at or below address, i.e. the routine the address is
+ * part of, or the address itself.
+ */
+void mc6809::location_name(char *buffer, size_t n, uint16_t address)
+{
+	std::vector<struct symbol>::iterator i = std::upper_bound(symbols.begin(),
+		symbols.end(), address,
+		[](uint16_t a, const struct symbol &s) { return a < s.address; });
+	if (i == symbols.begin()) {
+		snprintf(buffer, n, "$%04x", address);
+	} else {
+		snprintf(buffer, n, "%s", (i - 1)->name);
+	}
+}
@@ -0,0 +1,208 @@
+/*
+ * mc6809_syscalls.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Guest to host syscall gate. Guest code calls the host directly by
+ * means of 'sys #imm' ($11 $3e) or 'swi3' followed by an immediate
+ * byte, depending on the configured gate. Registers are marshalled into
+ * a struct, handed to the host function and written back afterwards.
+ */
+
+#include "mc6809.hpp"
+#include <chrono>
+
+void mc6809::register_syscall(uint8_t number, syscall_function function,
+			      void *data)
+{
+	syscalls[number].function = function;
+	syscalls[number].data = data;
+}
+
+void mc6809::install_default_syscalls()
+{
+	register_syscall(SYSCALL_MEMFILL, sys_memfill);
+	register_syscall(SYSCALL_MEMCPY, sys_memcpy);
+	register_syscall(SYSCALL_CYCLES, sys_cycles);
+	register_syscall(SYSCALL_HOST_TIME, sys_host_time);
+	register_syscall(SYSCALL_OPEN, sys_open);
+	register_syscall(SYSCALL_CLOSE, sys_close);
+	register_syscall(SYSCALL_READ, sys_read);
+	register_syscall(SYSCALL_WRITE, sys_write);
+}
+
+void mc6809::sys(uint16_t ea)
+{
+	if (syscall_gate == SYSCALL_GATE_OPCODE) {
+		do_syscall(bus_read8(ea));
+	} else {
+		ill(ea);
+	}
+}
+
+void mc6809::do_syscall(uint8_t number)
+{
+	if (syscalls[number].function == NULL) {
+		// unknown syscall
+		set_c_flag();
+		return;
+	}
+
+	struct mc6809_registers regs = {
+		pc, dp, ac, br, xr, yr, us, sp, cc
+	};
+
+	cycles += syscalls[number].function(this, &regs, syscalls[number].data);
+
+	pc = regs.pc;
+	dp = regs.dp;
+	ac = regs.ac;
+	br = regs.br;
+	xr = regs.xr;
+	yr = regs.yr;
+	us = regs.us;
+	if (sp != regs.sp) nmi_enabled = true;
+	sp = regs.sp;
+	cc = regs.cc;
+}
+
+uint16_t mc6809::sys_memfill(mc6809 *cpu, struct mc6809_registers *regs, void *)
+{
+	uint16_t address = regs->xr;
+	for (uint16_t i=0; i<regs->yr; i++) {
+		cpu->write8(address++, regs->ac);
+	}
+	regs->cc &= ~C_FLAG;
+	return 0;
+}
+
+uint16_t mc6809::sys_memcpy(mc6809 *cpu, struct mc6809_registers *regs, void *)
+{
+	uint16_t source = regs->xr;
+	uint16_t destination = regs->yr;
+	for (uint16_t i=0; i<regs->us; i++) {
+		cpu->write8(destination++, cpu->read8(source++));
+	}
+	regs->cc &= ~C_FLAG;
+	return 0;
+}
+
+uint16_t mc6809::sys_cycles(mc6809 *cpu, struct mc6809_registers *regs, void *)
+{
+	uint32_t ticks = cpu->clock_ticks();
+	regs->ac = (ticks & 0xff000000) >> 24;
+	regs->br = (ticks & 0x00ff0000) >> 16;
+	regs->xr = ticks & 0xffff;
+	regs->cc &= ~C_FLAG;
+	return 0;
+}
+
+uint16_t mc6809::sys_host_time(mc6809 *, struct mc6809_registers *regs, void *)
+{
+	uint32_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	regs->ac = (ms & 0xff000000) >> 24;
+	regs->br = (ms & 0x00ff0000) >> 16;
+	regs->xr = ms & 0xffff;
+	regs->cc &= ~C_FLAG;
+	return 0;
+}
+
+uint16_t mc6809::sys_open(mc6809 *cpu, struct mc6809_registers *regs, void *)
+{
+	const char *modes[3] = { "rb", "wb", "ab" };
+
+	char filename[256];
+	uint16_t address = regs->xr;
+	int i;
+	for (i=0; i<255; i++) {
+		filename[i] = cpu->read8(address++);
+		if (filename[i] == '\0') break;
+	}
+	filename[i] = '\0';
+
+	regs->cc |= C_FLAG;
+	if (regs->ac > 2) return 0;
+
+	for (int handle=3; handle<SYSCALL_MAX_FILES; handle++) {
+		if (cpu->syscall_files[handle] == NULL) {
+			cpu->syscall_files[handle] = fopen(filename, modes[regs->ac]);
+			if (cpu->syscall_files[handle]) {
+				regs->br = handle;
+				regs->cc &= ~C_FLAG;
+			}
+			return 0;
+		}
+	}
+	return 0;
+}
+
+uint16_t mc6809::sys_close(mc6809 *cpu, struct mc6809_registers *regs, void *)
+{
+	if ((regs->br < 3) || (regs->br >= SYSCALL_MAX_FILES) ||
+	    (cpu->syscall_files[regs->br] == NULL)) {
+		regs->cc |= C_FLAG;
+		return 0;
+	}
+	fclose(cpu->syscall_files[regs->br]);
+	cpu->syscall_files[regs->br] = NULL;
+	regs->cc &= ~C_FLAG;
+	return 0;
+}
+
+/*
+ * Maps a handle to a stream, handles 0, 1 and 2 are the standard streams
+ */
+static FILE *syscall_stream(FILE **files, uint8_t handle)
+{
+	switch (handle) {
+	case 0:
+		return stdin;
+	case 1:
+		return stdout;
+	case 2:
+		return stderr;
+	default:
+		return (handle < SYSCALL_MAX_FILES) ? files[handle] : NULL;
+	}
+}
+
+uint16_t mc6809::sys_read(mc6809 *cpu, struct mc6809_registers *regs, void *)
+{
+	FILE *f = syscall_stream(cpu->syscall_files, regs->br);
+	if (f == NULL) {
+		regs->cc |= C_FLAG;
+		return 0;
+	}
+
+	uint16_t address = regs->xr;
+	uint16_t count = 0;
+	int c;
+	while ((count < regs->yr) && ((c = fgetc(f)) != EOF)) {
+		cpu->write8(address++, c);
+		count++;
+	}
+	regs->yr = count;
+	regs->cc &= ~C_FLAG;
+	return 0;
+}
+
+uint16_t mc6809::sys_write(mc6809 *cpu, struct mc6809_registers *regs, void *)
+{
+	FILE *f = syscall_stream(cpu->syscall_files, regs->br);
+	if (f == NULL) {
+		regs->cc |= C_FLAG;
+		return 0;
+	}
+
+	uint16_t address = regs->xr;
+	uint16_t count = 0;
+	while (count < regs->yr) {
+		if (fputc(cpu->read8(address++), f) == EOF) break;
+		count++;
+	}
+	fflush(f);
+	regs->yr = count;
+	regs->cc &= ~C_FLAG;
+	return 0;
+}
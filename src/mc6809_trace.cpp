@@ -0,0 +1,81 @@
+/*
+ * mc6809_trace.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Binary execution trace
+ */
+
+#include "mc6809.hpp"
+#include <cstring>
+
+void mc6809::enable_trace(bool enable, uint32_t records)
+{
+	if (enable) {
+		uint32_t size = 1;
+		while ((size < records) && (size < 0x80000000)) size <<= 1;
+		if ((trace_buffer == NULL) || (size != trace_mask + 1)) {
+			delete [] trace_buffer;
+			trace_buffer = new struct mc6809_trace_record[size];
+			trace_mask = size - 1;
+			reset_trace();
+		}
+		instruments |= INSTRUMENT_TRACE;
+	} else {
+		instruments &= ~INSTRUMENT_TRACE;
+	}
+}
+
+void mc6809::reset_trace()
+{
+	trace_head = 0;
+	trace_cycles = 0;
+}
+
+uint64_t mc6809::get_trace_records()
+{
+	if (trace_buffer == NULL) return 0;
+	return trace_head > trace_mask ? (uint64_t)trace_mask + 1 : trace_head;
+}
+
+bool mc6809::save_trace(const char *filename)
+{
+	if (trace_buffer == NULL) return false;
+
+	FILE *f = fopen(filename, "wb");
+	if (f == NULL) return false;
+
+	uint64_t records = get_trace_records();
+	uint64_t first = trace_head - records;
+
+	/*
+	 * The cycles before the oldest record follow from the deltas of
+	 * the records still in the ring.
+	 */
+	uint64_t base_cycles = trace_cycles;
+	for (uint64_t i=first; i<trace_head; i++) {
+		base_cycles -= trace_buffer[i & trace_mask].cycles;
+	}
+
+	struct mc6809_trace_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRACE_MAGIC, 8);
+	header.version = TRACE_VERSION;
+	header.record_size = sizeof(struct mc6809_trace_record);
+	header.records = records;
+	header.base_cycles = base_cycles;
+
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+	/*
+	 * Oldest first, in at most two parts
+	 */
+	uint32_t start = first & trace_mask;
+	uint64_t part = (uint64_t)trace_mask + 1 - start;
+	if (part > records) part = records;
+	ok = ok && (fwrite(&trace_buffer[start], sizeof(struct mc6809_trace_record), part, f) == part);
+	ok = ok && (fwrite(trace_buffer, sizeof(struct mc6809_trace_record), records - part, f) == records - part);
+
+	fclose(f);
+	return ok;
+}
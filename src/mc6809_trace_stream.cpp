@@ -0,0 +1,243 @@
+/*
+ * mc6809_trace_stream.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Streaming execution trace to an mmap'd file (POSIX). The file grows
+ * in chunks. A background thread extends the file, maps the next
+ * chunks ahead of time and unmaps the filled ones, so the cpu thread
+ * only stores records into memory and never waits for write(2).
+ */
+
+#include "mc6809.hpp"
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*
+ * Number of chunks kept mapped ahead of the cpu
+ */
+#define	STREAM_CHUNKS_AHEAD	2
+
+struct stream_chunk {
+	uint8_t *map;
+	size_t length;
+	struct mc6809_trace_record *records;
+};
+
+class trace_stream {
+public:
+	int fd;
+	uint32_t chunk_records;
+	uint64_t chunks_prepared;
+	uint64_t records_done;
+	uint64_t stalls;
+	bool error;
+
+	struct stream_chunk current;
+	struct mc6809_trace_record scratch;	// sink after an error
+	std::deque<struct stream_chunk> ready;
+	std::deque<struct stream_chunk> filled;
+
+	std::mutex mutex;
+	std::condition_variable wake_thread;
+	std::condition_variable wake_cpu;
+	bool quit;
+	std::thread thread;
+
+	void run();
+	bool map_chunk(uint64_t index, struct stream_chunk *chunk);
+};
+
+/*
+ * Chunk n holds records n * chunk_records and on, after the header.
+ * mmap offsets must be page aligned, so the mapping starts at the page
+ * the chunk starts in.
+ */
+bool trace_stream::map_chunk(uint64_t index, struct stream_chunk *chunk)
+{
+	size_t bytes = (size_t)chunk_records * sizeof(struct mc6809_trace_record);
+	off_t start = sizeof(struct mc6809_trace_header) + index * bytes;
+	off_t page = sysconf(_SC_PAGESIZE);
+	off_t aligned = start & ~(page - 1);
+
+	if (ftruncate(fd, start + bytes) != 0) return false;
+
+	/*
+	 * Where available, pages are faulted in here instead of by the
+	 * cpu thread.
+	 */
+#ifdef MAP_POPULATE
+	int flags = MAP_SHARED | MAP_POPULATE;
+#else
+	int flags = MAP_SHARED;
+#endif
+	chunk->length = start - aligned + bytes;
+	chunk->map = (uint8_t *)mmap(NULL, chunk->length, PROT_READ | PROT_WRITE,
+		flags, fd, aligned);
+	if (chunk->map == MAP_FAILED) return false;
+	chunk->records = (struct mc6809_trace_record *)(chunk->map + (start - aligned));
+	return true;
+}
+
+void trace_stream::run()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true) {
+		wake_thread.wait(lock, [this] {
+			return quit || !filled.empty() || (!error && (ready.size() < STREAM_CHUNKS_AHEAD));
+		});
+
+		while (!filled.empty()) {
+			struct stream_chunk chunk = filled.front();
+			filled.pop_front();
+			lock.unlock();
+			msync(chunk.map, chunk.length, MS_ASYNC);
+			munmap(chunk.map, chunk.length);
+			lock.lock();
+		}
+
+		if (quit) break;
+
+		while (!error && (ready.size() < STREAM_CHUNKS_AHEAD)) {
+			uint64_t index = chunks_prepared++;
+			lock.unlock();
+			struct stream_chunk chunk;
+			bool ok = map_chunk(index, &chunk);
+			lock.lock();
+			if (ok) {
+				ready.push_back(chunk);
+			} else {
+				error = true;
+			}
+			wake_cpu.notify_one();
+		}
+	}
+}
+
+bool mc6809::start_trace_stream(const char *filename, uint32_t chunk_records)
+{
+	stop_trace_stream();
+
+	int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) return false;
+
+	stream = new trace_stream;
+	stream->fd = fd;
+	stream->chunk_records = chunk_records ? chunk_records : 1;
+	stream->chunks_prepared = 0;
+	stream->records_done = 0;
+	stream->stalls = 0;
+	stream->error = false;
+	stream->quit = false;
+	stream->current.map = NULL;
+
+	stream_next = NULL;
+	stream_end = NULL;
+	stream->thread = std::thread(&trace_stream::run, stream);
+
+	instruments |= INSTRUMENT_TRACE_STREAM;
+	return true;
+}
+
+/*
+ * Slow path of trace_stream_step(), the cpu only waits here when the
+ * background thread hasn't kept up, which shouldn't happen with chunks
+ * of a reasonable size.
+ */
+void mc6809::next_stream_chunk()
+{
+	std::unique_lock<std::mutex> lock(stream->mutex);
+
+	if (stream->current.map) {
+		stream->filled.push_back(stream->current);
+		stream->current.map = NULL;
+		stream->records_done += stream->chunk_records;
+	}
+
+	if (stream->ready.empty()) {
+		stream->stalls++;
+		stream->wake_thread.notify_one();
+		stream->wake_cpu.wait(lock, [this] {
+			return !stream->ready.empty() || stream->error;
+		});
+	}
+
+	if (stream->ready.empty()) {
+		/*
+		 * Disk full or similar, recording stops. Only full chunks
+		 * made it to the file.
+		 */
+		instruments &= ~INSTRUMENT_TRACE_STREAM;
+		stream_next = &stream->scratch;
+		stream_end = stream_next + 1;
+		return;
+	}
+
+	stream->current = stream->ready.front();
+	stream->ready.pop_front();
+	stream->wake_thread.notify_one();
+
+	stream_next = stream->current.records;
+	stream_end = stream_next + stream->chunk_records;
+}
+
+uint64_t mc6809::get_trace_stream_records()
+{
+	if (stream == NULL) return 0;
+	return stream->records_done +
+		(stream->current.map ? stream_next - stream->current.records : 0);
+}
+
+bool mc6809::stop_trace_stream()
+{
+	if (stream == NULL) return false;
+
+	instruments &= ~INSTRUMENT_TRACE_STREAM;
+
+	uint64_t records = get_trace_stream_records();
+
+	{
+		std::lock_guard<std::mutex> lock(stream->mutex);
+		if (stream->current.map) stream->filled.push_back(stream->current);
+		stream->quit = true;
+	}
+	stream->wake_thread.notify_one();
+	stream->thread.join();
+
+	/*
+	 * Chunks mapped ahead are dropped and the file is cut to the
+	 * records written, then the header is completed. After an error
+	 * this still leaves a valid file with the full chunks, but false
+	 * is returned.
+	 */
+	for (auto &chunk : stream->ready) {
+		munmap(chunk.map, chunk.length);
+	}
+
+	struct mc6809_trace_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRACE_MAGIC, 8);
+	header.version = TRACE_VERSION;
+	header.record_size = sizeof(struct mc6809_trace_record);
+	header.records = records;
+	header.base_cycles = 0;
+
+	bool ok = (ftruncate(stream->fd, sizeof(header) +
+			records * sizeof(struct mc6809_trace_record)) == 0) &&
+		(pwrite(stream->fd, &header, sizeof(header), 0) == sizeof(header)) &&
+		!stream->error;
+	close(stream->fd);
+
+	delete stream;
+	stream = NULL;
+	stream_next = NULL;
+	stream_end = NULL;
+	return ok;
+}
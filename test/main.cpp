@@ -33,8 +33,10 @@ public:
 char *read_line(void);
 void memory_dump(cpu_t *c, uint16_t address, int rows);
 bool hex_string_to_int(const char *temp_string, uint16_t *return_value);
+const char *skip_tokens(const char *line, int n);
 
 char text_buffer[512];
+char input_line[256];
 #define TEXT_BUFFER_SIZE 64
 
 int main()
@@ -77,6 +79,7 @@ int main()
 	do {
 		putchar(prompt);
 		input_string = read_line();
+		snprintf(input_line, sizeof(input_line), "%s", input_string);
 		token0 = strtok(input_string, " ");
 		token1 = strtok(NULL, " ");
 		token2 = strtok(NULL, " ");
@@ -92,41 +95,176 @@ int main()
 		} else if (strcmp(token0, "b") == 0) {
 			if (token1 == NULL) {
 				uint16_t count = 0;
+				uint16_t conditional = 0;
 				for (int i=0; i< 65536; i++) {
-					if (cpu.breakpoint_array[i]) {
+					if (cpu.is_breakpoint(i)) {
+						if (cpu.get_breakpoint_condition(i)) {
+							conditional++;
+							continue;
+						}
 						printf("%04x ", i);
 						count++;
 						if ((count % 4) == 0)
 							putchar('\n');
 					}
 				}
-				if (count == 0) {
+				if ((count % 4) != 0) putchar('\n');
+				for (int i=0; i< 65536; i++) {
+					if (cpu.is_breakpoint(i) && cpu.get_breakpoint_condition(i)) {
+						printf("%04x if %s\n", i, cpu.get_breakpoint_condition(i));
+					}
+				}
+				if ((count + conditional) == 0) {
 					puts("no breakpoints");
-				} else {
-					printf("\n");
 				}
 			} else {
+				/*
+				 * b address              toggle breakpoint
+				 * b address condition    conditional breakpoint,
+				 *                        e.g. b e012 x>$2000 && hits>100
+				 */
 				uint16_t temp_16bit;
-				if (hex_string_to_int(token1, &temp_16bit)) {
-					temp_16bit &= 0xffff;
+				if (!hex_string_to_int(token1, &temp_16bit)) {
+					puts("error: invalid address\n");
+				} else if (token2 == NULL) {
 					cpu.toggle_breakpoint(temp_16bit);
 					printf("breakpoint %s at $%04x\n",
-						cpu.breakpoint_array[temp_16bit] ? "set" : "cleared",
+						cpu.is_breakpoint(temp_16bit) ? "set" : "cleared",
 						temp_16bit);
+				} else if (cpu.set_conditional_breakpoint(temp_16bit,
+						skip_tokens(input_line, 2))) {
+					printf("breakpoint set at $%04x if %s\n", temp_16bit,
+						cpu.get_breakpoint_condition(temp_16bit));
 				} else {
-					puts("error: invalid address\n");
+					puts("error: invalid condition\n");
 				}
 			}
 		} else if (strcmp(token0, "br") == 0) {
 			printf("$%02x\n", cpu.get_br());
+		} else if (strcmp(token0, "cg") == 0) {
+			/*
+			 * cg on|off|clear
+			 * cg sym file        load symbols from vlink map file
+			 * cg write file      write callgrind file
+			 * cg csv             call edges with exclusive cycles
+			 */
+			if (token1 && (strcmp(token1, "on") == 0)) {
+				cpu.enable_callgraph(true);
+				puts("call graph enabled");
+			} else if (token1 && (strcmp(token1, "off") == 0)) {
+				cpu.enable_callgraph(false);
+				puts("call graph disabled");
+			} else if (token1 && (strcmp(token1, "clear") == 0)) {
+				cpu.reset_callgraph();
+				puts("call graph cleared");
+			} else if (token1 && token2 && (strcmp(token1, "sym") == 0)) {
+				cpu.clear_symbols();
+				if (!cpu.load_symbols(token2)) puts("error: can't read map file");
+			} else if (token1 && token2 && (strcmp(token1, "write") == 0)) {
+				if (!cpu.write_callgrind(token2)) puts("error: can't write callgrind file");
+			} else if (token1 && (strcmp(token1, "csv") == 0)) {
+				cpu.callgraph_csv(stdout);
+			} else {
+				puts("error: usage cg on|off|clear|sym file|write file|csv");
+			}
+		} else if (strcmp(token0, "cov") == 0) {
+			/*
+			 * cov on|off|clear
+			 * cov save|merge file
+			 * cov list|sum start end
+			 */
+			uint16_t start, end;
+			if (token1 && (strcmp(token1, "on") == 0)) {
+				cpu.enable_coverage(true);
+				puts("coverage enabled");
+			} else if (token1 && (strcmp(token1, "off") == 0)) {
+				cpu.enable_coverage(false);
+				puts("coverage disabled");
+			} else if (token1 && (strcmp(token1, "clear") == 0)) {
+				cpu.reset_coverage();
+				puts("coverage cleared");
+			} else if (token1 && token2 && (strcmp(token1, "save") == 0)) {
+				if (!cpu.save_coverage(token2)) puts("error: can't write file");
+			} else if (token1 && token2 && (strcmp(token1, "merge") == 0)) {
+				if (!cpu.merge_coverage(token2)) puts("error: can't read coverage file");
+			} else if (token1 && token2 && token3 &&
+				   hex_string_to_int(token2, &start) &&
+				   hex_string_to_int(token3, &end) &&
+				   (strcmp(token1, "list") == 0)) {
+				cpu.coverage_listing(stdout, start, end);
+			} else if (token1 && token2 && token3 &&
+				   hex_string_to_int(token2, &start) &&
+				   hex_string_to_int(token3, &end) &&
+				   (strcmp(token1, "sum") == 0)) {
+				cpu.coverage_summary(stdout, start, end);
+			} else {
+				puts("error: usage cov on|off|clear|save file|merge file|list start end|sum start end");
+			}
 		} else if (strcmp(token0, "dr") == 0) {
 			printf("$%04x\n", cpu.get_dr());
 		} else if (strcmp(token0, "firq") == 0) {
 			firq_pin = !firq_pin;
 			printf("changed status of firq to %c\n", firq_pin ? '1' : '0');
+		} else if (strcmp(token0, "heat") == 0) {
+			/*
+			 * heat on|off|clear|bus
+			 * heat pgm|csv file [rwf]    256x256 map of reads,
+			 *                            writes and/or fetches
+			 */
+			uint8_t type = HEAT_READ | HEAT_WRITE | HEAT_FETCH;
+			if (token3) {
+				type = 0;
+				if (strchr(token3, 'r')) type |= HEAT_READ;
+				if (strchr(token3, 'w')) type |= HEAT_WRITE;
+				if (strchr(token3, 'f')) type |= HEAT_FETCH;
+			}
+			if (token1 && (strcmp(token1, "on") == 0)) {
+				cpu.enable_heatmap(true);
+				puts("heatmap enabled");
+			} else if (token1 && (strcmp(token1, "off") == 0)) {
+				cpu.enable_heatmap(false);
+				puts("heatmap disabled");
+			} else if (token1 && (strcmp(token1, "clear") == 0)) {
+				cpu.reset_heatmap();
+				puts("heatmap cleared");
+			} else if (token1 && (strcmp(token1, "bus") == 0)) {
+				cpu.bus_statistics_csv(stdout);
+			} else if (token1 && token2 && ((strcmp(token1, "pgm") == 0) ||
+							(strcmp(token1, "csv") == 0))) {
+				FILE *f = fopen(token2, "wb");
+				if (f == NULL) {
+					puts("error: can't write file");
+				} else {
+					if (token1[0] == 'p') {
+						cpu.heatmap_pgm(f, type);
+					} else {
+						cpu.heatmap_csv(f, type);
+					}
+					fclose(f);
+				}
+			} else {
+				puts("error: usage heat on|off|clear|bus|pgm file [rwf]|csv file [rwf]");
+			}
 		} else if (strcmp(token0, "irq") == 0) {
 			irq_pin = !irq_pin;
 			printf("changed status of irq to %c\n", irq_pin ? '1' : '0');
+		} else if (strcmp(token0, "lat") == 0) {
+			/*
+			 * lat on|off|clear
+			 * lat [entries]      latency report, masked periods
+			 */
+			if (token1 && (strcmp(token1, "on") == 0)) {
+				cpu.enable_interrupt_latency(true);
+				puts("interrupt latency enabled");
+			} else if (token1 && (strcmp(token1, "off") == 0)) {
+				cpu.enable_interrupt_latency(false);
+				puts("interrupt latency disabled");
+			} else if (token1 && (strcmp(token1, "clear") == 0)) {
+				cpu.reset_interrupt_latency();
+				puts("interrupt latency cleared");
+			} else {
+				cpu.interrupt_latency_report(stdout, token1 ? atoi(token1) : 16);
+			}
 		} else if (strcmp(token0, "m") == 0) {
 			uint16_t temp_pc = cpu.get_pc();
 
@@ -156,6 +294,13 @@ int main()
 			int32_t cycles_done = cpu.execute();
 			if (cpu.breakpoint())
 				printf("reached breakpoint at: %04x\n", cpu.get_pc());
+			if (cpu.watchpoint()) {
+				printf("watchpoint: %s $%02x at $%04x by instruction at $%04x\n",
+					cpu.get_watchpoint_hit().type == WATCH_READ ? "read" : "write",
+					cpu.get_watchpoint_hit().value,
+					cpu.get_watchpoint_hit().address,
+					cpu.get_watchpoint_hit().pc);
+			}
 			printf("last run took %i cycles\n\n", cycles_done);
 			cpu.status(text_buffer, 512);
 			printf("%s\n\n", text_buffer);
@@ -167,6 +312,61 @@ int main()
 		} else if (strcmp(token0, "nmi") == 0) {
 			nmi_pin = !nmi_pin;
 			printf("changed status of nmi to %c\n", nmi_pin ? '1' : '0');
+		} else if (strcmp(token0, "prof") == 0) {
+			/*
+			 * prof on|off|clear
+			 * prof [entries]     hot-spot report
+			 */
+			if (token1 && (strcmp(token1, "on") == 0)) {
+				cpu.enable_profiler(true);
+				puts("profiler enabled");
+			} else if (token1 && (strcmp(token1, "off") == 0)) {
+				cpu.enable_profiler(false);
+				puts("profiler disabled");
+			} else if (token1 && (strcmp(token1, "clear") == 0)) {
+				cpu.reset_profiler();
+				puts("profiler cleared");
+			} else {
+				cpu.profiler_report(stdout, token1 ? atoi(token1) : 16);
+			}
+		} else if (strcmp(token0, "smp") == 0) {
+			/*
+			 * smp on [period]|off|clear
+			 * smp write file     write folded stacks
+			 */
+			if (token1 && (strcmp(token1, "on") == 0)) {
+				cpu.enable_sampler(true, token2 ? atoi(token2) : 100);
+				puts("sampler enabled");
+			} else if (token1 && (strcmp(token1, "off") == 0)) {
+				cpu.enable_sampler(false);
+				puts("sampler disabled");
+			} else if (token1 && (strcmp(token1, "clear") == 0)) {
+				cpu.reset_sampler();
+				puts("sampler cleared");
+			} else if (token1 && token2 && (strcmp(token1, "write") == 0)) {
+				if (!cpu.write_folded_stacks(token2)) puts("error: can't write file");
+			} else {
+				puts("error: usage smp on [period]|off|clear|write file");
+			}
+		} else if (strcmp(token0, "stat") == 0) {
+			/*
+			 * stat on|off|clear
+			 * stat [csv|json]    print statistics
+			 */
+			if (token1 && (strcmp(token1, "on") == 0)) {
+				cpu.enable_statistics(true);
+				puts("statistics enabled");
+			} else if (token1 && (strcmp(token1, "off") == 0)) {
+				cpu.enable_statistics(false);
+				puts("statistics disabled");
+			} else if (token1 && (strcmp(token1, "clear") == 0)) {
+				cpu.reset_statistics();
+				puts("statistics cleared");
+			} else if (token1 && (strcmp(token1, "json") == 0)) {
+				cpu.statistics_json(stdout);
+			} else {
+				cpu.statistics_csv(stdout);
+			}
 		} else if (strcmp(token0, "r") == 0) {
 			cpu.status(text_buffer, 512);
 			printf("%s\n\n", text_buffer);
@@ -188,6 +388,70 @@ int main()
 		} else if (strcmp(token0, "s") == 0) {
 			cpu.stacks(text_buffer, 512, 8);
 			printf("%s\n", text_buffer);
+		} else if (strcmp(token0, "tr") == 0) {
+			/*
+			 * tr on [records]|off|clear
+			 * tr save file       decode with mc6809_trace
+			 * tr stream file     stream to file until tr stop
+			 */
+			if (token1 && (strcmp(token1, "on") == 0)) {
+				cpu.enable_trace(true, token2 ? atoi(token2) : 1 << 20);
+				puts("trace enabled");
+			} else if (token1 && (strcmp(token1, "off") == 0)) {
+				cpu.enable_trace(false);
+				puts("trace disabled");
+			} else if (token1 && (strcmp(token1, "clear") == 0)) {
+				cpu.reset_trace();
+				puts("trace cleared");
+			} else if (token1 && token2 && (strcmp(token1, "stream") == 0)) {
+				if (cpu.start_trace_stream(token2)) {
+					printf("streaming trace to %s\n", token2);
+				} else {
+					puts("error: can't open file");
+				}
+			} else if (token1 && (strcmp(token1, "stop") == 0)) {
+				uint64_t records = cpu.get_trace_stream_records();
+				if (cpu.stop_trace_stream()) {
+					printf("%llu records streamed\n", (unsigned long long)records);
+				} else {
+					puts("error: no complete stream");
+				}
+			} else if (token1 && token2 && (strcmp(token1, "save") == 0)) {
+				if (cpu.save_trace(token2)) {
+					printf("%llu records saved\n",
+						(unsigned long long)cpu.get_trace_records());
+				} else {
+					puts("error: can't write trace");
+				}
+			} else {
+				puts("error: usage tr on [records]|off|clear|save file|stream file|stop");
+			}
+		} else if (strcmp(token0, "w") == 0) {
+			/*
+			 * w                  clear all watchpoints
+			 * w start [end] [r|w|rw]
+			 */
+			uint16_t start, end;
+			if (token1 == NULL) {
+				cpu.clear_watchpoints();
+				puts("watchpoints cleared");
+			} else if (hex_string_to_int(token1, &start)) {
+				end = start;
+				const char *type_string = "rw";
+				if (token2 && hex_string_to_int(token2, &end)) {
+					if (token3) type_string = token3;
+				} else if (token2) {
+					type_string = token2;
+				}
+				uint8_t type = 0;
+				if (strchr(type_string, 'r')) type |= WATCH_READ;
+				if (strchr(type_string, 'w')) type |= WATCH_WRITE;
+				cpu.add_watchpoint(start, end, type);
+				printf("watchpoint (%s) set at $%04x-$%04x\n",
+					type_string, start, end);
+			} else {
+				puts("error: invalid address\n");
+			}
 		} else if (strcmp(token0, "x") == 0) {
 			finished = true;
 		} else {
@@ -271,3 +535,17 @@ bool hex_string_to_int(const char *temp_string, uint16_t *return_value)
 	*return_value = val;
 	return true;
 }
+
+/*
+ * Returns a pointer to the remainder of line after skipping n space
+ * separated tokens.
+ */
+const char *skip_tokens(const char *line, int n)
+{
+	for (int i=0; i<n; i++) {
+		while (*line == ' ') line++;
+		while (*line && (*line != ' ')) line++;
+	}
+	while (*line == ' ') line++;
+	return line;
+}
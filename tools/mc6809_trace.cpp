@@ -0,0 +1,97 @@
+/*
+ * mc6809_trace.cpp  -  part of MC6809
+ *
+ * (C)2021-2025 elmerucr
+ *
+ * Offline decoder for binary execution traces (save_trace()). Usage:
+ *
+ *   mc6809_trace trace.bin [rom.map]
+ */
+
+#include "mc6809.hpp"
+#include <cstdio>
+#include <cstring>
+
+/*
+ * The disassembler reads through read8(), here it only sees the
+ * instruction bytes of the record being decoded.
+ */
+class decoder_t : public mc6809 {
+public:
+	const struct mc6809_trace_record *record;
+
+	uint8_t read8(uint16_t address) const {
+		uint16_t offset = address - record->pc;
+		return offset < 5 ? record->bytes[offset] : 0;
+	}
+	void write8(uint16_t address, uint8_t value) const {}
+};
+
+static const char *entry_names[5] = {
+	"", "nmi", "firq", "irq", "wait"
+};
+
+int main(int argc, char **argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s trace.bin [map file]\n", argv[0]);
+		return 1;
+	}
+
+	FILE *f = fopen(argv[1], "rb");
+	if (f == NULL) {
+		fprintf(stderr, "error: can't open %s\n", argv[1]);
+		return 1;
+	}
+
+	struct mc6809_trace_header header;
+	if ((fread(&header, sizeof(header), 1, f) != 1) ||
+	    memcmp(header.magic, TRACE_MAGIC, 8) ||
+	    (header.version != TRACE_VERSION) ||
+	    (header.record_size != sizeof(struct mc6809_trace_record))) {
+		fprintf(stderr, "error: %s is not a trace file\n", argv[1]);
+		fclose(f);
+		return 1;
+	}
+
+	decoder_t decoder;
+	if ((argc > 2) && !decoder.load_symbols(argv[2])) {
+		fprintf(stderr, "error: can't read %s\n", argv[2]);
+	}
+
+	char text[64];
+	uint64_t cycles = header.base_cycles;
+	struct mc6809_trace_record record;
+	decoder.record = &record;
+
+	for (uint64_t i=0; i<header.records; i++) {
+		if (fread(&record, sizeof(record), 1, f) != 1) {
+			fprintf(stderr, "error: trace truncated at record %llu\n",
+				(unsigned long long)i);
+			break;
+		}
+		cycles += record.cycles;
+
+		if (const char *label = decoder.get_symbol(record.pc)) {
+			printf("%s:\n", label);
+		}
+
+		if (record.type == TRACE_INSTRUCTION) {
+			decoder.disassemble_instruction(text, sizeof(text), record.pc);
+		} else {
+			snprintf(text, sizeof(text), "%04x <%s>", record.pc,
+				entry_names[record.type <= TRACE_WAIT ? record.type : 0]);
+		}
+
+		printf("%12llu %-38s a=%02x b=%02x x=%04x y=%04x u=%04x s=%04x dp=%02x cc=%c%c%c%c%c%c%c%c\n",
+			(unsigned long long)cycles, text, record.ac, record.br,
+			record.xr, record.yr, record.us, record.sp, record.dp,
+			record.cc & 0x80 ? 'e' : '-', record.cc & 0x40 ? 'f' : '-',
+			record.cc & 0x20 ? 'h' : '-', record.cc & 0x10 ? 'i' : '-',
+			record.cc & 0x08 ? 'n' : '-', record.cc & 0x04 ? 'z' : '-',
+			record.cc & 0x02 ? 'v' : '-', record.cc & 0x01 ? 'c' : '-');
+	}
+
+	fclose(f);
+	return 0;
+}